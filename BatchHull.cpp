@@ -0,0 +1,229 @@
+// BatchHull.cpp
+#include "BatchHull.h"
+#include "HullStats.h"
+#include <iostream>
+#include <climits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+// --------------------------------------------------------------------------------------
+// This file contains the implementation of the class BatchHull.
+// --------------------------------------------------------------------------------------
+
+/* The number of datasets every worker may have in flight, read but not yet
+ * printed. A slow dataset holds back the printing of the ones after it, so
+ * the others keep the workers busy meanwhile. */
+static const int DATASETS_PER_WORKER = 4;
+
+/**
+ * Constructor, of a batch whose hulls are computed with the given engine, by
+ * the given number of workers
+ */
+BatchHull::BatchHull(const HullEngine engine, const bool cull, const int workers):
+                     _engine(engine), _cull(cull), _workers(workers), _datasets(0),
+                     _complete(true){}
+
+
+/** Returns the number of datasets read, all of whose hulls are printed by the
+ * time run() returns */
+long long BatchHull::datasets() const
+{
+	return _datasets;
+}
+
+
+/**
+ * Reads all the datasets of the given reader, and prints their hulls in
+ * order. A single worker computes the hulls in the calling thread.
+ */
+bool BatchHull::run(PointReader& reader, const BatchFraming framing, PointWriter& output)
+{
+	if(_workers > 1)
+	{
+		_runWorkers(reader, framing, output);
+	}
+	else
+	{
+		_runSequential(reader, framing, output);
+	}
+	return _complete;
+}
+
+
+/**
+ * Reads the next dataset into the given buffer, which keeps its capacity. A
+ * delimited dataset ends at the next delimiter line or at the end of the
+ * input, and a counted one after its count of points.
+ */
+bool BatchHull::_readDataset(PointReader& reader, const BatchFraming framing,
+                             vector<Point>& points)
+{
+	HULL_TIME(PARSE_PHASE);
+	int count = INT_MAX;
+	if(framing == COUNTED_DATASETS ? !reader.nextCount(count) : !reader.nextDataset())
+	{
+		return false;
+	}
+
+	_datasets++;
+	points.clear();
+	int x, y;
+	while((int)points.size() < count and reader.next(x, y))
+	{
+		points.push_back(Point(x, y));
+	}
+	if(framing == COUNTED_DATASETS and (int)points.size() < count)
+	{
+		cerr << "Dataset " << _datasets << " ended after " << points.size() << " of its "
+		     << count << " points" << endl;
+		_complete = false;
+	}
+	return true;
+}
+
+
+/**
+ * Leaves the hull of the given points in the given set. The set is assigned
+ * the points, so its array and hash index are reused when they are large
+ * enough, and the graham and monotone engines trim the set in place.
+ */
+void BatchHull::_computeHull(const vector<Point>& points, PointSet& set) const
+{
+	{
+		HULL_TIME(ADD_PHASE);
+		set.assign(points.data(), points.data() + points.size());
+	}
+	if(_cull)
+	{
+		cullInteriorPoints(set);
+	}
+	computeHull(set, _engine);
+}
+
+
+/**
+ * Computes the hulls in the calling thread, reusing a single buffer and a
+ * single set for all datasets. Every hull is flushed once printed, so that it
+ * is seen at once even if the input never ends.
+ */
+void BatchHull::_runSequential(PointReader& reader, const BatchFraming framing,
+                               PointWriter& output)
+{
+	vector<Point> points;
+	PointSet set;
+	while(_readDataset(reader, framing, points))
+	{
+		_computeHull(points, set);
+		HULL_TIME(OUTPUT_PHASE);
+		output.write("result\n");
+		output.write(set);
+		output.flush();
+	}
+}
+
+
+/**
+ * Computes the hulls in a pool of worker threads. The datasets in flight are
+ * held in a ring of slots, the dataset with sequence number s in slot
+ * s % slots.size(). The calling thread reads every dataset into its slot,
+ * workers take the datasets in the order they were read and compute their
+ * hulls, and the calling thread prints the hulls as the datasets at the head
+ * of the ring are done, so the output keeps the order of the input. Reading
+ * waits while the ring is full, which bounds the memory held by the batch.
+ */
+void BatchHull::_runWorkers(PointReader& reader, const BatchFraming framing,
+                            PointWriter& output)
+{
+	vector<Dataset> slots(_workers * DATASETS_PER_WORKER);
+	long long read = 0; // Datasets read into their slots
+	long long taken = 0; // Datasets taken by workers
+	long long printed = 0; // Datasets printed, whose slots are free again
+	bool finished = false; // True once the input has ended
+	mutex lock;
+	condition_variable datasetRead;
+	condition_variable hullComputed;
+
+	vector<thread> workers;
+	for(int t = 0; t < _workers; t++)
+	{
+		workers.push_back(thread([&]()
+		{
+			PointSet set;
+			unique_lock<mutex> guard(lock);
+			while(true)
+			{
+				datasetRead.wait(guard, [&](){ return taken < read or finished; });
+				if(taken == read)
+				{
+					HULL_MERGE_THREAD_STATS();
+					return;
+				}
+				Dataset& dataset = slots[taken++ % slots.size()];
+				guard.unlock();
+				_computeHull(dataset.points, set);
+				{
+					HULL_TIME(OUTPUT_PHASE);
+					dataset.hull = set.toString();
+				}
+				guard.lock();
+				dataset.done = true;
+				hullComputed.notify_one();
+			}
+		}));
+	}
+
+	bool more = true;
+	unique_lock<mutex> guard(lock);
+	while(more or printed < read)
+	{
+		/* Reading the next dataset into a free slot. Only the calling thread
+		 * touches a slot between its printing and its reading. */
+		if(more and read - printed < (long long)slots.size())
+		{
+			Dataset& dataset = slots[read % slots.size()];
+			guard.unlock();
+			more = _readDataset(reader, framing, dataset.points);
+			guard.lock();
+			if(more)
+			{
+				dataset.done = false;
+				read++;
+				datasetRead.notify_one();
+			}
+			else
+			{
+				finished = true;
+				datasetRead.notify_all();
+			}
+		}
+
+		/* Printing the hulls at the head of the ring that are done, waiting
+		 * for the head if there is nothing else to do */
+		if(printed < read and (!more or read - printed == (long long)slots.size()))
+		{
+			hullComputed.wait(guard, [&](){ return slots[printed % slots.size()].done; });
+		}
+		while(printed < read and slots[printed % slots.size()].done)
+		{
+			Dataset& dataset = slots[printed % slots.size()];
+			guard.unlock();
+			{
+				HULL_TIME(OUTPUT_PHASE);
+				output.write("result\n");
+				output.write(dataset.hull);
+				output.flush();
+			}
+			guard.lock();
+			printed++;
+		}
+	}
+	guard.unlock();
+
+	for(size_t t = 0; t < workers.size(); t++)
+	{
+		workers[t].join();
+	}
+}
@@ -0,0 +1,89 @@
+// BatchHull.h
+#ifndef BATCH_HULL_H
+#define BATCH_HULL_H
+
+#include <string>
+#include <vector>
+#include "Point.h"
+#include "PointSet.h"
+#include "PointReader.h"
+#include "PointWriter.h"
+#include "HullAlgorithms.h"
+
+using namespace std;
+
+/**
+ * The ways the datasets of a batch are told apart in its input: separated by
+ * delimiter lines, or each preceded by a line holding its count of points.
+ */
+enum BatchFraming
+{
+	DELIMITED_DATASETS,
+	COUNTED_DATASETS
+};
+
+/**
+ * This class computes the convex hulls of many datasets read from a single
+ * input, in one process. Every hull is printed in the same way as by a run of
+ * ConvexHull over its dataset alone, headed by "result", and the hulls are
+ * printed in the order of their datasets. The points of a dataset are read
+ * into a buffer, and copied into a set whose array and hash index are kept
+ * for the next dataset, so that datasets of similar sizes take no
+ * allocations. With more than one worker, the hulls of independent datasets
+ * are computed concurrently by a pool of threads, each with a set of its own,
+ * while the input is read and the hulls are printed by the calling thread.
+ */
+class BatchHull
+{
+public:
+
+	/**
+	 * Constructor, of a batch whose hulls are computed with the given engine,
+	 * after culling the interior points of every dataset if cull is true, by
+	 * the given number of workers
+	 */
+	BatchHull(const HullEngine engine, const bool cull, const int workers);
+
+	/**
+	 * Reads all the datasets of the given reader, framed in the given way,
+	 * and prints their hulls with the given writer. Malformed lines are
+	 * reported and skipped by the reader, and a dataset that ends before its
+	 * count of points is reported to the standard error stream.
+	 * @return True iff every dataset held its count of points
+	 */
+	bool run(PointReader& reader, const BatchFraming framing, PointWriter& output);
+
+	/** Returns the number of datasets read by run() */
+	long long datasets() const;
+
+private:
+
+	/** A dataset in flight in the worker pool, with its hull once computed */
+	struct Dataset
+	{
+		vector<Point> points;
+		string hull;
+		bool done;
+	};
+
+	HullEngine _engine;
+	bool _cull;
+	int _workers;
+	long long _datasets;
+	bool _complete; // False once a dataset ended before its count of points
+
+	/** Reads the next dataset into the given buffer. Returns false iff there
+	 * are no more datasets */
+	bool _readDataset(PointReader& reader, const BatchFraming framing, vector<Point>& points);
+
+	/** Leaves the hull of the given points in the given set */
+	void _computeHull(const vector<Point>& points, PointSet& set) const;
+
+	/** Computes the hulls in the calling thread, one dataset at a time */
+	void _runSequential(PointReader& reader, const BatchFraming framing, PointWriter& output);
+
+	/** Computes the hulls in a pool of worker threads */
+	void _runWorkers(PointReader& reader, const BatchFraming framing, PointWriter& output);
+};
+
+#endif
@@ -1,189 +1,371 @@
 // ConvexHull.cpp
 
-/* This program receives a list of points from the user. The Convex Hull of the
- * given points is calculated by the Grahm Scan algorithm, and the points
+/* This program receives a list of points from the user, either from the
+ * standard input or from a file given as an argument. The Convex Hull of the
+ * given points is calculated by the Grahm Scan algorithm, or by Andrew's
+ * monotone chain algorithm or Chan's algorithm if selected with the --engine
+ * option, optionally dividing the work between threads with the --threads
+ * option. With the --stream option the hull is instead maintained while the
+ * points are read, keeping only its vertices in memory. The points
  * comprising the hull are returned to the user, sorted by the x coordinates,
- * and secondly by the y coordinates. 
+ * and secondly by the y coordinates. The input may also be a binary point
+ * file, which is mapped and used in place, and the hull is written as one
+ * with the --binary-output option. A point file must be a file, given as an
+ * argument or redirected to the standard input: one coming through a pipe is
+ * rejected. With the --batch or --batch-counts options the input holds many
+ * datasets, whose hulls are printed one after the other, optionally computed
+ * by a pool of threads with the --workers option. With the --stats option the
+ * time taken by every phase, and the counts of the events behind them, are
+ * printed to the standard error as JSON when the program ends.
  */
 #include "Point.h"
 #include "PointSet.h"
+#include "PointReader.h"
+#include "PointFile.h"
+#include "PointWriter.h"
+#include "HullAlgorithms.h"
+#include "StreamingHull.h"
+#include "BatchHull.h"
+#include "HullStats.h"
 #include <iostream>
-#include <sstream>
 #include <string>
+#include <vector>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
 
-static const int MINIMAL_POINTS_IN_HULL = 3;
+/* The number of points read before they are added to the set together */
+static const size_t READ_CHUNK_SIZE = 1 << 16;
 
-/** Custom modulu operation. Adds the sum of the modulu to the result in case of
- * a negative modulu result. This allows "looping around" for indexes, also in
- * the negative direction */
-int modulu(const int a, const int b)
-{
-	int result = a % b;
-	return (result < 0) ? result + b: result;
-}
+/* The line that separates the datasets of a batch, unless given otherwise */
+static const char* const DEFAULT_DELIMITER = "---";
 
+static const char* const USAGE = "Usage: ConvexHull [--engine graham|monotone|chan] [--threads N] "
+                                 "[--cull] [--stream [--every N]] [--binary-output]\n"
+                                 "                  [--batch [--delimiter LINE] | --batch-counts] "
+                                 "[--workers N] [--stats] [input file]\n"
+                                 "A binary point file is read from a file or a redirection, not a pipe.";
 
-/** y-coordinate Point comparator. Points are compared by the y coordinate,
- * with ties broken by the x coordinate
+/**
+ * Gives the points of a mapped point file one at a time, in the same way as a
+ * PointReader gives the points of a text file
  */
-bool yCoordinateComparator(const Point*& p1, const Point*& p2)
+class PointFileSource
 {
-	if(p1 -> getY() == p2 -> getY())
+public:
+	PointFileSource(const Point* points, const int size): _points(points), _size(size), _next(0){}
+
+	bool next(int& x, int& y)
 	{
-		return p1 -> getX() < p2 -> getX();
+		if(_next == _size)
+		{
+			return false;
+		}
+		x = _points[_next].getX();
+		y = _points[_next].getY();
+		_next++;
+		return true;
 	}
-	return p1 -> getY() < p2 -> getY();
-}
 
+private:
+	const Point* _points;
+	const int _size;
+	int _next;
+};
 
-/** x-coordinate Point comparator. Points are compared by the x coordinate,
- * with ties broken by the y coordinate
+/**
+ * Prints the points of the given set to the standard output, so that they are
+ * seen at once. The points are printed as text, headed by "result", or as a
+ * binary point file if binary is true.
+ * @return True iff the points were printed
  */
-bool xCoordinateComparator(const Point*& p1, const Point*& p2)
+static bool printSet(const PointSet& set, const bool binary)
 {
-	if(p1 -> getX() == p2 -> getX())
+	HULL_TIME(OUTPUT_PHASE);
+	if(binary)
 	{
-		return p1 -> getY() < p2 -> getY();
+		return writePointFile(STDOUT_FILENO, set.getPoints(), set.size());
 	}
-	return p1 -> getX() < p2 -> getX();
+	PointWriter writer(STDOUT_FILENO);
+	writer.write("result\n");
+	writer.write(set);
+	return writer.flush();
 }
 
+/**
+ * Prints the current hull of the given stream, flushing the output so that it
+ * is seen at once even if the stream never ends
+ */
+static bool printHull(const StreamingHull& hull, const bool binary)
+{
+	PointSet set;
+	hull.getHull(set);
+	return printSet(set, binary);
+}
 
 /**
- * Compares two points according to their polar angle in comparison to a pivot.
- * This is done by calculating the slope of the vector connecting each point to
- * the pivot, and using the slope in order to compare the two. If the slope is
- * smaller, so is the polar angle. If one of the points is on the same line of
- * the pivot, the result is decided according to the location of that point in
- * comparison to the pivot on the x axis: to the right of the pivot - always
- * smaller, to the left - always larger. If one of the points IS the pivot, it
- * is always the smallest.
+ * Feeds the points of the given source, a PointReader or a PointFileSource, to
+ * a streaming hull, which keeps only the vertices of the hull, instead of
+ * holding all points in a set. The hull is printed when the input ends, and
+ * also after every given number of points if that number is positive.
+ * @return True iff all the hulls were printed
  */
-bool polarAngleComparator(const Point*& p1, const Point*& p2, const Point& pivot)
+template <typename PointSource>
+static bool streamHull(PointSource& source, const long long every, const bool binary)
 {
-	if(*p1 == pivot)
+	StreamingHull hull;
+	bool printed = true;
+	int x, y;
+	while(source.next(x, y))
 	{
-		return true;
+		hull.add(Point(x, y));
+		if(every > 0 and hull.pointsSeen() % every == 0)
+		{
+			printed = printHull(hull, binary) and printed;
+		}
 	}
+	return printHull(hull, binary) and printed;
+}
 
-	if(*p2 == pivot)
+/** Prints the statistics of the run to the standard error */
+static void printStatistics()
+{
+	printHullStats(cerr);
+}
+
+/**
+* Main function - receives points from user and returns the convex hull. Returns
+* 1 if the arguments were invalid, the input couldn't be opened or it had
+* malformed lines.
+*/
+int main(int argc, char* argv[])
+{
+	/* Parsing the command line options */
+	HullEngine engine = GRAHAM_SCAN;
+	int threads = 1;
+	bool cull = false;
+	bool stream = false;
+	bool binaryOutput = false;
+	long long every = 0;
+	bool batch = false;
+	BatchFraming framing = DELIMITED_DATASETS;
+	string delimiter = DEFAULT_DELIMITER;
+	bool delimited = false;
+	int workers = 1;
+	bool stats = false;
+	const char* inputFile = nullptr;
+	for(int i = 1; i < argc; i++)
 	{
-		return false;
+		string argument = argv[i];
+		if(argument == "--engine" and i + 1 < argc and getEngineByName(argv[i + 1], engine))
+		{
+			i++;
+		}
+		else if(argument == "--threads" and i + 1 < argc and (threads = atoi(argv[i + 1])) > 0)
+		{
+			i++;
+		}
+		else if(argument == "--cull")
+		{
+			cull = true;
+		}
+		else if(argument == "--stream")
+		{
+			stream = true;
+		}
+		else if(argument == "--binary-output")
+		{
+			binaryOutput = true;
+		}
+		else if(argument == "--every" and i + 1 < argc and (every = atoll(argv[i + 1])) > 0)
+		{
+			i++;
+		}
+		else if(argument == "--batch" or argument == "--batch-counts")
+		{
+			batch = true;
+			framing = (argument == "--batch") ? DELIMITED_DATASETS : COUNTED_DATASETS;
+		}
+		else if(argument == "--delimiter" and i + 1 < argc)
+		{
+			delimiter = argv[++i];
+			delimited = true;
+		}
+		else if(argument == "--workers" and i + 1 < argc and (workers = atoi(argv[i + 1])) > 0)
+		{
+			i++;
+		}
+		else if(argument == "--stats")
+		{
+			stats = true;
+		}
+		else if(argument.compare(0, 2, "--") != 0 and inputFile == nullptr)
+		{
+			inputFile = argv[i];
+		}
+		else
+		{
+			cerr << USAGE << endl;
+			return 1;
+		}
 	}
-	
-	if(p1 -> getY() == pivot.getY())
+	/* A batch is read as text, and its hulls are printed as text, each
+	 * computed by a single thread. Only a batch of delimited datasets has a
+	 * delimiter. */
+	if((batch and (stream or binaryOutput or threads > 1)) or
+	   (delimited and (!batch or framing != DELIMITED_DATASETS)))
 	{
-		return p1 -> getX() > pivot.getX();
+		cerr << USAGE << endl;
+		return 1;
 	}
-	
-	if(p2 -> getY() == pivot.getY())
+	/* Only a streamed hull is printed as the points come */
+	if(every > 0 and !stream)
 	{
-		return !(p2 -> getX() > pivot.getX());
+		cerr << USAGE << endl;
+		return 1;
 	}
 
-	double slope1 = (p1 -> getX() - pivot.getX()) / (double) (p1 -> getY() - pivot.getY());
-	double slope2 = (p2 -> getX() - pivot.getX()) / (double) (p2 -> getY() - pivot.getY());
-	return slope1 > slope2;
-}
-
-/** 
- * Checks what turn is formed with the line between the three given points.
- * Returns a positive number for a left turn, a negative for a right turn, and
- * 0 if all points are on the same line
- */
-int getTurnDirection(const Point* p1, const Point* p2, const Point* p3)
-{
-	return (p2 -> getX() - p1 -> getX())*(p3 -> getY() - p1 -> getY()) - (p2 ->
-			getY() - p1 -> getY())*(p3 -> getX() - p1 -> getX()); 
-}
+	/* The statistics are printed however the program returns */
+	if(stats and !hullStatsEnabled())
+	{
+		cerr << "Statistics are compiled out, build with -DHULL_STATS to collect them" << endl;
+	}
+	else if(stats)
+	{
+		atexit(printStatistics);
+	}
 
+	int fd = STDIN_FILENO;
+	if(inputFile != nullptr and (fd = open(inputFile, O_RDONLY)) < 0)
+	{
+		cerr << "Cannot open input file " << inputFile << endl;
+		return 1;
+	}
 
-/** Receives a PointSet object with a pivot point located at the start of the
- * set. The pivot point is defined as the lowest and most left point in the
- * set. The function uses the Grahm Scan algorithm in order to locate the
- * points in the set which constitute the convex hull. These points are swapped
- * within the given set so they comprise the first M places, with M being the
- * number of points in the convex hull. This M is returned by the function.
- * The grahm scan algorithm was taken from the wikipedia article:
- * https://en.wikipedia.org/wiki/Graham_scan. The algorithm's complexity is 
- * dominated by the sort - so the complexity is O(n log n). The actual scan, 
- * after the sort is performed, is of complexity O(n).
- */
-int grahmScanSort(PointSet& set)
-{
-	// No point in performing the algorithm for less than three points
-	if(set.size() < MINIMAL_POINTS_IN_HULL)
+	/* A binary point file is mapped, and its points are used in place: the set
+	 * adopts them as its array, without copying or parsing them. The file
+	 * outlives the set, which holds its points in it. */
+	PointFile file;
+	PointSet set;
+	int errors = 0;
+	bool printed = true;
+	if(batch)
 	{
-		return set.size();
+		/* Computing the hulls of all the datasets of the input, which are
+		 * printed in order */
+		if(PointFile::isPointFile(fd))
+		{
+			cerr << "A batch is read from text, not from a point file" << endl;
+			return 1;
+		}
+		PointReader reader(fd);
+		if(reader.startsWith(POINT_FILE_MAGIC, sizeof(POINT_FILE_MAGIC)))
+		{
+			cerr << "A batch is read from text, not from a point file" << endl;
+			return 1;
+		}
+		if(framing == DELIMITED_DATASETS)
+		{
+			reader.setDelimiter(delimiter);
+		}
+		BatchHull batchHull(engine, cull, workers);
+		PointWriter writer(STDOUT_FILENO);
+		bool complete = batchHull.run(reader, framing, writer);
+		printed = writer.flush();
+		errors = reader.errorCount();
+		if(fd != STDIN_FILENO)
+		{
+			close(fd);
+		}
+		return (errors == 0 and complete and printed) ? 0 : 1;
 	}
-	
-	
-	int i = 1;
-	int hullSize = 0; // For index convenience, the hull size is counted from
-	                  // 0. The actual size will be returned incremented by 1.
-	
-	// Taking care of the point in index 1. Using the last point in the set as
-	// the predecessor to the first (pivot) point.
-	while(getTurnDirection(set[set.size() - 1], set[hullSize], set[i]) <= 0 and i < set.size() - 1)
+	if(PointFile::isPointFile(fd))
 	{
-		i++;
+		bool mapped;
+		{
+			HULL_TIME(PARSE_PHASE);
+			mapped = file.map(fd);
+		}
+		if(fd != STDIN_FILENO)
+		{
+			close(fd);
+		}
+		if(!mapped)
+		{
+			return 1;
+		}
+		if(!file.holds<int>())
+		{
+			cerr << "The point file doesn't hold 32 bit integer coordinates" << endl;
+			return 1;
+		}
+		if(stream)
+		{
+			PointFileSource source(file.points<int>(), file.size());
+			return streamHull(source, every, binaryOutput) ? 0 : 1;
+		}
+		HULL_TIME(ADD_PHASE);
+		set.adopt(file.points<int>(), file.size());
 	}
-	hullSize++;
-	set.swapPoints(hullSize, i);
-
-	//Iterating over the rest of the points.
-	for(i++ ; i < set.size(); i++)
+	else
 	{
-		while(getTurnDirection(set[modulu(hullSize-1, set.size())], set[hullSize], set[i]) <= 0)
+		/* Receiving input and adding the points to the set. The reader parses
+		 * the input in place, and the points are handed to the set in chunks,
+		 * each added and deduplicated in a single pass. A point file is only
+		 * told from text here if it couldn't be mapped, as from a pipe. */
+		PointReader reader(fd);
+		if(reader.startsWith(POINT_FILE_MAGIC, sizeof(POINT_FILE_MAGIC)))
+		{
+			cerr << "A point file can't be read through a pipe, give it as a file or redirect it" << endl;
+			return 1;
+		}
+		if(stream)
+		{
+			printed = streamHull(reader, every, binaryOutput);
+		}
+		else
 		{
-			hullSize--;
+			vector<Point> chunk;
+			chunk.reserve(READ_CHUNK_SIZE);
+			int x, y;
+			bool more = true;
+			while(more)
+			{
+				chunk.clear();
+				{
+					HULL_TIME(PARSE_PHASE);
+					while(chunk.size() < READ_CHUNK_SIZE and (more = reader.next(x, y)))
+					{
+						chunk.push_back(Point(x, y));
+					}
+				}
+				HULL_TIME(ADD_PHASE);
+				set.addRange(chunk.data(), chunk.data() + chunk.size());
+			}
+		}
+		errors = reader.errorCount();
+		if(fd != STDIN_FILENO)
+		{
+			close(fd);
+		}
+		if(stream)
+		{
+			return (errors == 0 and printed) ? 0 : 1;
 		}
-		hullSize++;
-		set.swapPoints(hullSize, i);
 	}
-	return ++hullSize; 
-}
 
-/**
-* Main function - receives points from user and returns the convex hull 
-*/
-int main()
-{
-	/* Receiving input, creating corresponding Points, and adding them to the
-	 * set. Since the set creates a copy of the points, original points are
-	 * deleted */
-	string line, coordinateInput;
-	PointSet set;
-	Point* newPoint;
-	istringstream stream;
-	int x, y;
-	while(getline(cin, line))
-	{	
-		stream.str(line);
-		getline(stream, coordinateInput, ',');
-		x = stoi(coordinateInput);
-		getline(stream, coordinateInput);
-		y = stoi(coordinateInput);
-		newPoint = new Point(x, y);
-		set.add(*newPoint);		
-		delete(newPoint);
-		stream.clear();
+	/* Removing the points that are clearly inside the hull, if requested,
+	 * and reporting how many were removed */
+	if(cull)
+	{
+		int inputSize = set.size();
+		int culled = cullInteriorPoints(set);
+		cerr << "Culled " << culled << " of " << inputSize << " points" << endl;
 	}
-	
-	/* Sorting set according to polar comparison to the pivot - the point with
-	 * the lowest y (ties broken by x) */
-	const Point* min = set.getMinimum(yCoordinateComparator);
-	PointSet::PivotComparator polarComparator(*min, polarAngleComparator);
-	set.sortSet(polarComparator);
-	
-	/*Running the grahm scan algorithm. The Points consisting the convex hull
-	 * will be swapped to the start of the set */
-	int hullSize = grahmScanSort(set);
-
-	/* Trimming the set so only the points in the hull remain, sorting
-	 * according to the x coordinate and printing. */
-	set.trim(set.size()- hullSize);
-	set.sortSet(xCoordinateComparator);
-	cout << "result" << endl;
-	cout << set.toString();
+
+	/* Computing the hull. Only the points of the hull remain in the set,
+	 * sorted according to the x coordinate, and are then printed. */
+	computeHull(set, engine, threads);
+	printed = printSet(set, binaryOutput);
+	return (errors == 0 and printed) ? 0 : 1;
 }
@@ -0,0 +1,444 @@
+// DynamicHull.cpp
+#include "DynamicHull.h"
+#include "HullAlgorithms.h"
+#include <algorithm>
+#include <iterator>
+
+using namespace std;
+
+// --------------------------------------------------------------------------------------
+// This file contains the implementation of the class DynamicHull.
+// --------------------------------------------------------------------------------------
+
+
+static const int UPPER_SIDE = 1;
+static const int LOWER_SIDE = -1;
+
+/* The index of a missing node */
+static const int NO_NODE = -1;
+
+/* A subtree is rebuilt once one of its children holds more than 3/4 of its
+ * leaves, which keeps the depth of the tree logarithmic */
+static const int BALANCE_NUMERATOR = 3;
+static const int BALANCE_DENOMINATOR = 4;
+
+
+/** Returns true iff the first point comes before the second, by the x
+ * coordinate and secondly by the y coordinate */
+static inline bool pointLess(const Point& p1, const Point& p2)
+{
+	return p1.getX() < p2.getX() or (p1.getX() == p2.getX() and p1.getY() < p2.getY());
+}
+
+
+/**
+ * Constructs an empty tree, for the upper chain if the given side is 1 or the
+ * lower chain if it is -1
+ */
+DynamicHull::BridgeTree::BridgeTree(const int side): _root(NO_NODE), _side(side){}
+
+
+/** Returns the turn formed by the three given points, mirrored for the lower
+ * chain, so that the vertices of both chains form right turns */
+int DynamicHull::BridgeTree::_turn(const Point& p1, const Point& p2, const Point& p3) const
+{
+	return _side * getTurnDirection(&p1, &p2, &p3);
+}
+
+
+/** Returns true iff the given node is a leaf */
+bool DynamicHull::BridgeTree::_isLeaf(const int node) const
+{
+	return _nodes[node].left == NO_NODE;
+}
+
+
+/** Returns a new node with the given key and no children. Freed nodes are
+ * reused before the array of nodes is grown. */
+int DynamicHull::BridgeTree::_newNode(const Point& key)
+{
+	Node node = {NO_NODE, NO_NODE, NO_NODE, 1, key, key, key};
+	if(_freeNodes.empty())
+	{
+		_nodes.push_back(node);
+		return _nodes.size() - 1;
+	}
+	int index = _freeNodes.back();
+	_freeNodes.pop_back();
+	_nodes[index] = node;
+	return index;
+}
+
+
+/** Returns the given node to the free nodes */
+void DynamicHull::BridgeTree::_freeNode(const int node)
+{
+	_freeNodes.push_back(node);
+}
+
+
+/**
+ * Returns the vertex of the chain of the given subtree that is the tangent
+ * from the given point, which lies before all of its points: the whole chain
+ * is to the right of the line from the point to the vertex, and among vertices
+ * on that line the farthest is returned. The chain of the subtree is made of
+ * the chain of its left subtree up to the bridge, and of the chain of its
+ * right subtree from the bridge. If the right end of the bridge is to the left
+ * of the line from the point to the left end, or on it, the tangent is on the
+ * right part, and it is then also the tangent to the whole chain of the right
+ * subtree, as the rest of that chain is below the bridge. Otherwise it is on
+ * the left part, likewise. The descent takes O(log n).
+ */
+Point DynamicHull::BridgeTree::_tangentFromLeft(const Point& point, int node) const
+{
+	while(!_isLeaf(node))
+	{
+		const Node& current = _nodes[node];
+		node = (_turn(point, current.bridgeLeft, current.bridgeRight) >= 0) ? current.right
+		                                                                     : current.left;
+	}
+	return _nodes[node].key;
+}
+
+
+/**
+ * Computes the bridge of the given internal node, from the chains of its
+ * children. The left end of the bridge is searched for by descending the left
+ * subtree: at every node, the tangent from the left end of its bridge to the
+ * right subtree shows on which side of its bridge the left end lies. If the
+ * right end of its bridge is strictly to the left of that tangent, the left
+ * end of the bridge is further right. The right end is then the tangent from
+ * the left end. The search takes O(log^2 n).
+ */
+void DynamicHull::BridgeTree::_computeBridge(const int node)
+{
+	int rightSubtree = _nodes[node].right;
+	int current = _nodes[node].left;
+	while(!_isLeaf(current))
+	{
+		Point left = _nodes[current].bridgeLeft;
+		Point right = _nodes[current].bridgeRight;
+		Point tangent = _tangentFromLeft(left, rightSubtree);
+		current = (_turn(left, tangent, right) > 0) ? _nodes[current].right : _nodes[current].left;
+	}
+	Point bridgeLeft = _nodes[current].key;
+	_nodes[node].bridgeLeft = bridgeLeft;
+	_nodes[node].bridgeRight = _tangentFromLeft(bridgeLeft, rightSubtree);
+}
+
+
+/** Builds a balanced subtree over the given sorted points, and returns its
+ * root. The bridges are computed from the leaves up. */
+int DynamicHull::BridgeTree::_buildSubtree(const Point* points, const int n)
+{
+	if(n == 1)
+	{
+		return _newNode(points[0]);
+	}
+
+	int middle = n / 2;
+	int left = _buildSubtree(points, middle);
+	int right = _buildSubtree(points + middle, n - middle);
+	int node = _newNode(points[middle - 1]);
+	_nodes[node].left = left;
+	_nodes[node].right = right;
+	_nodes[node].size = n;
+	_nodes[left].parent = node;
+	_nodes[right].parent = node;
+	_computeBridge(node);
+	return node;
+}
+
+
+/** Appends the points of the given subtree to the given vector, in order, and
+ * frees its nodes */
+void DynamicHull::BridgeTree::_collectAndFree(const int node, vector<Point>& points)
+{
+	if(_isLeaf(node))
+	{
+		points.push_back(_nodes[node].key);
+	}
+	else
+	{
+		_collectAndFree(_nodes[node].left, points);
+		_collectAndFree(_nodes[node].right, points);
+	}
+	_freeNode(node);
+}
+
+
+/** Rebuilds the tree from the given points, in any order */
+void DynamicHull::BridgeTree::build(const Point* points, const int n)
+{
+	_nodes.clear();
+	_freeNodes.clear();
+	_root = NO_NODE;
+	if(n == 0)
+	{
+		return;
+	}
+
+	vector<Point> sorted(points, points + n);
+	sort(sorted.begin(), sorted.end(), pointLess);
+	_nodes.reserve(2 * n);
+	_root = _buildSubtree(&sorted[0], n);
+}
+
+
+/**
+ * Walks up from the given node to the root, updating the sizes. If a subtree
+ * on the way became unbalanced, the highest such subtree is rebuilt. The
+ * bridges of the nodes on the way are then recomputed from the bottom up,
+ * starting above the rebuilt subtree if there is one.
+ */
+void DynamicHull::BridgeTree::_update(int node)
+{
+	int unbalanced = NO_NODE;
+	for(int current = node; current != NO_NODE; current = _nodes[current].parent)
+	{
+		Node& currentNode = _nodes[current];
+		currentNode.size = _nodes[currentNode.left].size + _nodes[currentNode.right].size;
+		int largerChild = max(_nodes[currentNode.left].size, _nodes[currentNode.right].size);
+		if(BALANCE_DENOMINATOR * largerChild > BALANCE_NUMERATOR * currentNode.size)
+		{
+			unbalanced = current;
+		}
+	}
+
+	if(unbalanced != NO_NODE)
+	{
+		int parent = _nodes[unbalanced].parent;
+		bool isLeftChild = (parent != NO_NODE and _nodes[parent].left == unbalanced);
+		vector<Point> points;
+		_collectAndFree(unbalanced, points);
+		int rebuilt = _buildSubtree(&points[0], points.size());
+		_nodes[rebuilt].parent = parent;
+		if(parent == NO_NODE)
+		{
+			_root = rebuilt;
+		}
+		else if(isLeftChild)
+		{
+			_nodes[parent].left = rebuilt;
+		}
+		else
+		{
+			_nodes[parent].right = rebuilt;
+		}
+		node = parent;
+	}
+
+	for(int current = node; current != NO_NODE; current = _nodes[current].parent)
+	{
+		_computeBridge(current);
+	}
+}
+
+
+/** Adds the given point, which must not be in the tree. The leaf where the
+ * search for the point ends is replaced by an internal node over that leaf
+ * and a new leaf for the point. */
+void DynamicHull::BridgeTree::insert(const Point& point)
+{
+	int leaf = _newNode(point);
+	if(_root == NO_NODE)
+	{
+		_root = leaf;
+		return;
+	}
+
+	int sibling = _root;
+	while(!_isLeaf(sibling))
+	{
+		sibling = pointLess(_nodes[sibling].key, point) ? _nodes[sibling].right
+		                                                : _nodes[sibling].left;
+	}
+
+	bool pointFirst = pointLess(point, _nodes[sibling].key);
+	int node = _newNode(pointFirst ? point : _nodes[sibling].key);
+	int parent = _nodes[sibling].parent;
+	_nodes[node].left = pointFirst ? leaf : sibling;
+	_nodes[node].right = pointFirst ? sibling : leaf;
+	_nodes[node].parent = parent;
+	if(parent == NO_NODE)
+	{
+		_root = node;
+	}
+	else if(_nodes[parent].left == sibling)
+	{
+		_nodes[parent].left = node;
+	}
+	else
+	{
+		_nodes[parent].right = node;
+	}
+	_nodes[sibling].parent = node;
+	_nodes[leaf].parent = node;
+	_update(node);
+}
+
+
+/** Removes the given point, which must be in the tree. Its leaf is removed
+ * along with its parent, which is replaced by the sibling of the leaf. */
+void DynamicHull::BridgeTree::erase(const Point& point)
+{
+	int leaf = _root;
+	while(!_isLeaf(leaf))
+	{
+		leaf = pointLess(_nodes[leaf].key, point) ? _nodes[leaf].right : _nodes[leaf].left;
+	}
+
+	int parent = _nodes[leaf].parent;
+	_freeNode(leaf);
+	if(parent == NO_NODE)
+	{
+		_root = NO_NODE;
+		return;
+	}
+
+	int sibling = (_nodes[parent].left == leaf) ? _nodes[parent].right : _nodes[parent].left;
+	int grandparent = _nodes[parent].parent;
+	_nodes[sibling].parent = grandparent;
+	_freeNode(parent);
+	if(grandparent == NO_NODE)
+	{
+		_root = sibling;
+		return;
+	}
+	if(_nodes[grandparent].left == parent)
+	{
+		_nodes[grandparent].left = sibling;
+	}
+	else
+	{
+		_nodes[grandparent].right = sibling;
+	}
+	_update(grandparent);
+}
+
+
+/** Appends the vertices of the chain of the given subtree that lie between
+ * the given points, inclusive, to the given vector. The given points are
+ * always vertices of the chain, so every subtree visited adds a vertex. */
+void DynamicHull::BridgeTree::_getChain(const int node, const Point& from, const Point& to,
+                                        vector<Point>& chain) const
+{
+	const Node& current = _nodes[node];
+	if(_isLeaf(node))
+	{
+		chain.push_back(current.key);
+		return;
+	}
+	if(!pointLess(current.bridgeLeft, from))
+	{
+		_getChain(current.left, from, pointLess(to, current.bridgeLeft) ? to : current.bridgeLeft,
+		          chain);
+	}
+	if(!pointLess(to, current.bridgeRight))
+	{
+		_getChain(current.right, pointLess(current.bridgeRight, from) ? from : current.bridgeRight,
+		          to, chain);
+	}
+}
+
+
+/** Appends the vertices of the chain to the given vector, from left to right.
+ * The chain runs from the first point to the last one. */
+void DynamicHull::BridgeTree::getChain(vector<Point>& chain) const
+{
+	if(_root == NO_NODE)
+	{
+		return;
+	}
+	int first = _root;
+	int last = _root;
+	while(!_isLeaf(first))
+	{
+		first = _nodes[first].left;
+	}
+	while(!_isLeaf(last))
+	{
+		last = _nodes[last].right;
+	}
+	_getChain(_root, _nodes[first].key, _nodes[last].key, chain);
+}
+
+
+/**
+ * Constructs the hull of the given set, and attaches it to the set
+ */
+DynamicHull::DynamicHull(PointSet& set): _set(set), _upper(UPPER_SIDE), _lower(LOWER_SIDE)
+{
+	setReset(set);
+	_set.addObserver(this);
+}
+
+
+/**
+ * Destructor. Detaches the hull from its set.
+ */
+DynamicHull::~DynamicHull()
+{
+	_set.removeObserver(this);
+}
+
+
+/** Updates the hull with a point added to the set */
+void DynamicHull::pointAdded(const Point& point)
+{
+	_upper.insert(point);
+	_lower.insert(point);
+}
+
+
+/** Updates the hull with a point removed from the set */
+void DynamicHull::pointRemoved(const Point& point)
+{
+	_upper.erase(point);
+	_lower.erase(point);
+}
+
+
+/** Rebuilds the hull from all the points of the set */
+void DynamicHull::setReset(const PointSet& set)
+{
+	_upper.build(set.getPoints(), set.size());
+	_lower.build(set.getPoints(), set.size());
+}
+
+
+/**
+ * Returns the number of vertices of the hull. Both chains run from the first
+ * point to the last one, so those are only counted once.
+ */
+int DynamicHull::size() const
+{
+	vector<Point> upper;
+	vector<Point> lower;
+	_upper.getChain(upper);
+	_lower.getChain(lower);
+	return upper.size() + lower.size() - min((int)upper.size(), 2);
+}
+
+
+/**
+ * Loads the given set with the vertices of the hull. The chains are both
+ * sorted, so they are merged in order, and the set drops the shared ends.
+ */
+void DynamicHull::getHull(PointSet& hull) const
+{
+	vector<Point> upper;
+	vector<Point> lower;
+	_upper.getChain(upper);
+	_lower.getChain(lower);
+	vector<Point> vertices;
+	vertices.reserve(upper.size() + lower.size());
+	merge(upper.begin(), upper.end(), lower.begin(), lower.end(), back_inserter(vertices),
+	      pointLess);
+
+	hull = PointSet();
+	for(size_t i = 0; i < vertices.size(); i++)
+	{
+		hull.add(vertices[i]);
+	}
+}
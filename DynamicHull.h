@@ -0,0 +1,162 @@
+// DynamicHull.h
+#ifndef DYNAMIC_HULL_H
+#define DYNAMIC_HULL_H
+
+#include <vector>
+#include "Point.h"
+#include "PointSet.h"
+#include "PointSetObserver.h"
+
+using namespace std;
+
+/**
+ * This class maintains the convex hull of a PointSet while points are added
+ * to and removed from the set, in the manner of Overmars and van Leeuwen. It
+ * observes the set, so every add, remove or trim of the set updates the hull
+ * in polylogarithmic time, and the hull can be read at any moment without
+ * being recomputed.
+ * The hull is kept as its upper and lower chains, in the sense of the
+ * monotone chain algorithm: the points are ordered by the x coordinate, and
+ * secondly by the y coordinate, and each chain is held by a BridgeTree.
+ */
+class DynamicHull: public PointSetObserver
+{
+public:
+
+	/**
+	 * Constructs the hull of the given set, and attaches it to the set. The
+	 * hull must be destroyed before the set.
+	 */
+	DynamicHull(PointSet& set);
+
+	/**
+	 * Destructor. Detaches the hull from its set.
+	 */
+	~DynamicHull();
+
+	/**
+	 * Returns the number of vertices of the hull
+	 */
+	int size() const;
+
+	/**
+	 * Loads the given set with the vertices of the hull, replacing its points.
+	 * The points are sorted by the x coordinate, and secondly by the y
+	 * coordinate, as left by computeHull.
+	 */
+	void getHull(PointSet& hull) const;
+
+	/** Updates the hull with a point added to the set */
+	void pointAdded(const Point& point);
+
+	/** Updates the hull with a point removed from the set */
+	void pointRemoved(const Point& point);
+
+	/** Rebuilds the hull from all the points of the set */
+	void setReset(const PointSet& set);
+
+private:
+
+	/**
+	 * A leaf oriented binary search tree over the points, ordered by the x
+	 * coordinate and secondly by the y coordinate. Every internal node holds
+	 * the bridge of its subtree: the edge of the chain of its subtree that
+	 * joins the chain of its left subtree to the chain of its right subtree.
+	 * The chain of a subtree is therefore the chain of its left subtree up to
+	 * the left end of the bridge, followed by the chain of its right subtree
+	 * from the right end of the bridge, and is searched by descending the tree
+	 * instead of being stored. The upper tree keeps the chain making right
+	 * turns from left to right, and the lower tree the one making left turns.
+	 * The tree is kept weight balanced by rebuilding unbalanced subtrees, as
+	 * in a scapegoat tree.
+	 */
+	class BridgeTree
+	{
+	public:
+		/**
+		 * Constructs an empty tree, for the upper chain if the given side is 1
+		 * or the lower chain if it is -1
+		 */
+		BridgeTree(const int side);
+
+		/** Rebuilds the tree from the given points, in any order */
+		void build(const Point* points, const int n);
+
+		/** Adds the given point, which must not be in the tree */
+		void insert(const Point& point);
+
+		/** Removes the given point, which must be in the tree */
+		void erase(const Point& point);
+
+		/** Appends the vertices of the chain to the given vector, from left to
+		 * right */
+		void getChain(vector<Point>& chain) const;
+
+	private:
+		/** A node of the tree. A leaf holds a single point as its key, and an
+		 * internal node holds the largest point of its left subtree. */
+		struct Node
+		{
+			int left;
+			int right;
+			int parent;
+			int size; // The number of leaves in the subtree
+			Point key;
+			Point bridgeLeft;
+			Point bridgeRight;
+		};
+
+		vector<Node> _nodes;
+		vector<int> _freeNodes;
+		int _root;
+		int _side;
+
+		/** Returns the turn formed by the three given points, mirrored for the
+		 * lower chain, so that the vertices of both chains form right turns */
+		int _turn(const Point& p1, const Point& p2, const Point& p3) const;
+
+		/** Returns true iff the given node is a leaf */
+		bool _isLeaf(const int node) const;
+
+		/** Returns a new node with the given key and no children */
+		int _newNode(const Point& key);
+
+		/** Returns the given node to the free nodes */
+		void _freeNode(const int node);
+
+		/** Returns the vertex of the chain of the given subtree that is the
+		 * tangent from the given point, which lies before all of its points */
+		Point _tangentFromLeft(const Point& point, int node) const;
+
+		/** Computes the bridge of the given internal node, from the chains of
+		 * its children */
+		void _computeBridge(const int node);
+
+		/** Builds a balanced subtree over the given sorted points, and returns
+		 * its root */
+		int _buildSubtree(const Point* points, const int n);
+
+		/** Appends the points of the given subtree to the given vector, in
+		 * order, and frees its nodes */
+		void _collectAndFree(const int node, vector<Point>& points);
+
+		/** Walks up from the given node to the root, updating the sizes,
+		 * rebuilding the highest subtree that became unbalanced, and
+		 * recomputing the bridges of all nodes on the way */
+		void _update(int node);
+
+		/** Appends the vertices of the chain of the given subtree that lie
+		 * between the given points, inclusive, to the given vector */
+		void _getChain(const int node, const Point& from, const Point& to,
+		               vector<Point>& chain) const;
+	};
+
+	PointSet& _set;
+	BridgeTree _upper;
+	BridgeTree _lower;
+
+	DynamicHull(const DynamicHull&);
+	DynamicHull& operator=(const DynamicHull&);
+};
+
+#endif
@@ -0,0 +1,822 @@
+// HullAlgorithms.cpp
+#include "HullAlgorithms.h"
+#include "SimdKernels.h"
+#include "HullStats.h"
+#include <cstdlib>
+#include <cassert>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+using namespace std;
+
+// --------------------------------------------------------------------------------------
+// This file contains the implementation of the convex hull algorithms.
+// --------------------------------------------------------------------------------------
+
+
+static const int MINIMAL_POINTS_IN_HULL = 3;
+
+/* Splitting the set between threads only pays off when every thread receives
+ * a substantial chunk of points */
+static const int MINIMAL_POINTS_PER_THREAD = 10000;
+
+/* The culling stage tests the points in blocks small enough to stay in cache */
+static const int CULL_BLOCK_SIZE = 4096;
+
+/** Custom modulu operation. Adds the sum of the modulu to the result in case of
+ * a negative modulu result. This allows "looping around" for indexes, also in
+ * the negative direction */
+static int modulu(const int a, const int b)
+{
+	int result = a % b;
+	return (result < 0) ? result + b: result;
+}
+
+
+/**
+ * Constructs the key of the given point around the given pivot
+ */
+PolarAngleKey::PolarAngleKey(const Point& point, const Point& pivot):
+                             _dx((long long)point.getX() - pivot.getX()),
+                             _dy((long long)point.getY() - pivot.getY())
+{
+	if(_dx == 0 and _dy == 0)
+	{
+		_halfPlane = 0;
+	}
+	else
+	{
+		_halfPlane = (_dy > 0 or (_dy == 0 and _dx > 0)) ? 1 : 2;
+	}
+}
+
+
+/**
+ * Compares the keys by half plane, then by the sign of the cross product of
+ * their vectors, and then by the length of the vectors.
+ */
+bool PolarAngleKey::operator<(const PolarAngleKey& other) const
+{
+	HULL_COUNT(POLAR_COMPARISONS, 1);
+	if(_halfPlane != other._halfPlane)
+	{
+		return _halfPlane < other._halfPlane;
+	}
+
+	// The products may not fit in 64 bits for coordinates far apart
+	__int128 cross = (__int128)_dx * other._dy - (__int128)_dy * other._dx;
+	if(cross != 0)
+	{
+		return cross > 0;
+	}
+	return llabs(_dx) + llabs(_dy) < llabs(other._dx) + llabs(other._dy);
+}
+
+
+/**
+ * Constructs a key function around the given pivot
+ */
+PolarAngleKeyFunction::PolarAngleKeyFunction(const Point& pivot): _pivot(pivot){}
+
+
+/**
+ * Returns the key of the given point
+ */
+PolarAngleKey PolarAngleKeyFunction::operator()(const Point& point) const
+{
+	return PolarAngleKey(point, _pivot);
+}
+
+
+/** Returns the sign of the given value: 1, -1 or 0 */
+template <typename Number>
+static inline int signOf(const Number value)
+{
+	return (value > 0) - (value < 0);
+}
+
+
+/**
+ * Returns the turn direction of the given points of narrow integer
+ * coordinates. The cross product is computed in 128 bits, so the result is
+ * exact.
+ */
+template <typename Coordinate>
+static int turnDirection(const BasicPoint<Coordinate>* p1, const BasicPoint<Coordinate>* p2,
+                         const BasicPoint<Coordinate>* p3, true_type, true_type)
+{
+	__int128 cross = (__int128)((long long)p2 -> getX() - p1 -> getX()) *
+	                 ((long long)p3 -> getY() - p1 -> getY()) -
+	                 (__int128)((long long)p2 -> getY() - p1 -> getY()) *
+	                 ((long long)p3 -> getX() - p1 -> getX());
+	return signOf(cross);
+}
+
+
+/** Returns the absolute value of a difference of two 64 bit integers, which
+ * always fits in 64 unsigned bits */
+static inline unsigned __int128 magnitude(const __int128 difference)
+{
+	return (uint64_t)(difference < 0 ? -difference : difference);
+}
+
+
+/**
+ * Returns the turn direction of the given points of 64 bit integer
+ * coordinates. The differences of the coordinates take 65 bits, so their
+ * products may not fit in 128 bits with their signs. The signs and the
+ * magnitudes of the two products are taken apart instead, and the magnitudes
+ * are multiplied as unsigned 64 bit numbers, so the result is exact.
+ */
+template <typename Coordinate>
+static int turnDirection(const BasicPoint<Coordinate>* p1, const BasicPoint<Coordinate>* p2,
+                         const BasicPoint<Coordinate>* p3, false_type, true_type)
+{
+	__int128 dx2 = (__int128)p2 -> getX() - p1 -> getX();
+	__int128 dy2 = (__int128)p2 -> getY() - p1 -> getY();
+	__int128 dx3 = (__int128)p3 -> getX() - p1 -> getX();
+	__int128 dy3 = (__int128)p3 -> getY() - p1 -> getY();
+
+	int leftSign = signOf(dx2) * signOf(dy3);
+	int rightSign = signOf(dy2) * signOf(dx3);
+	if(leftSign != rightSign)
+	{
+		return signOf(leftSign - rightSign);
+	}
+	unsigned __int128 left = magnitude(dx2) * magnitude(dy3);
+	unsigned __int128 right = magnitude(dy2) * magnitude(dx3);
+	return leftSign * ((left > right) - (left < right));
+}
+
+
+/**
+ * Returns the turn direction of the given points of floating coordinates, by
+ * the sign of the cross product as it is rounded. Nearly collinear points may
+ * thus be found to turn either way.
+ */
+template <typename Coordinate>
+static int turnDirection(const BasicPoint<Coordinate>* p1, const BasicPoint<Coordinate>* p2,
+                         const BasicPoint<Coordinate>* p3, false_type, false_type)
+{
+	Coordinate cross = (p2 -> getX() - p1 -> getX()) * (p3 -> getY() - p1 -> getY()) -
+	                   (p2 -> getY() - p1 -> getY()) * (p3 -> getX() - p1 -> getX());
+	return signOf(cross);
+}
+
+
+/** 
+ * Checks what turn is formed with the line between the three given points.
+ * Returns a positive number for a left turn, a negative for a right turn, and
+ * 0 if all points are on the same line. The computation is picked at compile
+ * time by the coordinate type, and is exact for all integer coordinates.
+ */
+template <typename Coordinate>
+int getTurnDirection(const BasicPoint<Coordinate>* p1, const BasicPoint<Coordinate>* p2,
+                     const BasicPoint<Coordinate>* p3)
+{
+	return turnDirection(p1, p2, p3,
+	                     integral_constant<bool, CoordinateTraits<Coordinate>::isNarrow>(),
+	                     integral_constant<bool, CoordinateTraits<Coordinate>::isExact>());
+}
+
+template int getTurnDirection(const BasicPoint<int16_t>* p1, const BasicPoint<int16_t>* p2,
+                              const BasicPoint<int16_t>* p3);
+template int getTurnDirection(const BasicPoint<int32_t>* p1, const BasicPoint<int32_t>* p2,
+                              const BasicPoint<int32_t>* p3);
+template int getTurnDirection(const BasicPoint<int64_t>* p1, const BasicPoint<int64_t>* p2,
+                              const BasicPoint<int64_t>* p3);
+template int getTurnDirection(const BasicPoint<double>* p1, const BasicPoint<double>* p2,
+                              const BasicPoint<double>* p3);
+
+
+/** Receives a PointSet object with a pivot point located at the start of the
+ * set. The pivot point is defined as the lowest and most left point in the
+ * set. The function uses the Grahm Scan algorithm in order to locate the
+ * points in the set which constitute the convex hull. These points are swapped
+ * within the given set so they comprise the first M places, with M being the
+ * number of points in the convex hull. This M is returned by the function.
+ * The grahm scan algorithm was taken from the wikipedia article:
+ * https://en.wikipedia.org/wiki/Graham_scan. The algorithm's complexity is 
+ * dominated by the sort - so the complexity is O(n log n). The actual scan, 
+ * after the sort is performed, is of complexity O(n).
+ */
+int grahmScanSort(PointSet& set)
+{
+	// No point in performing the algorithm for less than three points
+	if(set.size() < MINIMAL_POINTS_IN_HULL)
+	{
+		return set.size();
+	}
+	
+	
+	int i = 1;
+	int hullSize = 0; // For index convenience, the hull size is counted from
+	                  // 0. The actual size will be returned incremented by 1.
+	
+	// Taking care of the point in index 1. Using the last point in the set as
+	// the predecessor to the first (pivot) point.
+	while(getTurnDirection(set[set.size() - 1], set[hullSize], set[i]) <= 0 and i < set.size() - 1)
+	{
+		i++;
+	}
+	hullSize++;
+	set.swapPoints(hullSize, i);
+
+	//Iterating over the rest of the points.
+	for(i++ ; i < set.size(); i++)
+	{
+		while(getTurnDirection(set[modulu(hullSize-1, set.size())], set[hullSize], set[i]) <= 0)
+		{
+			hullSize--;
+			HULL_COUNT(SCAN_BACKTRACKS, 1);
+		}
+		hullSize++;
+		set.swapPoints(hullSize, i);
+	}
+	return ++hullSize; 
+}
+
+
+/** Receives a PointSet object sorted by the x coordinate, and secondly by the
+ * y coordinate. The function uses Andrew's monotone chain algorithm in order
+ * to locate the points in the set which constitute the convex hull: the lower
+ * hull is built by scanning the points from left to right, and the upper hull
+ * by scanning them back from right to left, popping every point that doesn't
+ * form a left turn with its neighbours. The hull points are then moved within
+ * the set so they comprise the first M places, still sorted by their
+ * coordinates, with M being the number of points in the convex hull. This M is
+ * returned by the function. The scan is of complexity O(n).
+ */
+int monotoneChainSort(PointSet& set)
+{
+	int n = set.size();
+	if(n < MINIMAL_POINTS_IN_HULL)
+	{
+		return n;
+	}
+
+	// The chains hold the indexes of their points within the set
+	vector<int> chain;
+	chain.reserve(n);
+	vector<bool> inHull(n, false);
+
+	for(int i = 0; i < n; i++)
+	{
+		while(chain.size() >= 2 and getTurnDirection(set[chain[chain.size() - 2]],
+		                                             set[chain.back()], set[i]) <= 0)
+		{
+			chain.pop_back();
+			HULL_COUNT(SCAN_BACKTRACKS, 1);
+		}
+		chain.push_back(i);
+	}
+	for(size_t j = 0; j < chain.size(); j++)
+	{
+		inHull[chain[j]] = true;
+	}
+
+	chain.clear();
+	for(int i = n - 1; i >= 0; i--)
+	{
+		while(chain.size() >= 2 and getTurnDirection(set[chain[chain.size() - 2]],
+		                                             set[chain.back()], set[i]) <= 0)
+		{
+			chain.pop_back();
+			HULL_COUNT(SCAN_BACKTRACKS, 1);
+		}
+		chain.push_back(i);
+	}
+	for(size_t j = 0; j < chain.size(); j++)
+	{
+		inHull[chain[j]] = true;
+	}
+
+	// Moving the hull points to the start of the set. Since they are moved in
+	// increasing order of index, the set order is kept among them.
+	int hullSize = 0;
+	for(int i = 0; i < n; i++)
+	{
+		if(inHull[i])
+		{
+			set.swapPoints(hullSize, i);
+			hullSize++;
+		}
+	}
+	return hullSize;
+}
+
+
+/**
+ * Computes the convex hull of the given set with the Grahm Scan algorithm,
+ * leaving only the points of the hull in the set, sorted by coordinates.
+ */
+static void grahmScanHull(PointSet& set)
+{
+	/* Sorting set according to the polar angle around the pivot - the point
+	 * with the lowest y (ties broken by x). The polar angle key of every point
+	 * is computed once before sorting */
+	const Point* min;
+	{
+		HULL_TIME(MINIMUM_PHASE);
+		min = set.getMinimum(YCoordinateOrder());
+	}
+	if(min != nullptr)
+	{
+		HULL_TIME(POLAR_SORT_PHASE);
+		set.sortByKey(PolarAngleKeyFunction(*min));
+	}
+
+	/*Running the grahm scan algorithm. The Points consisting the convex hull
+	 * will be swapped to the start of the set */
+	int hullSize;
+	{
+		HULL_TIME(SCAN_PHASE);
+		hullSize = grahmScanSort(set);
+	}
+
+	/* Trimming the set so only the points in the hull remain, and sorting
+	 * according to the x coordinate. */
+	{
+		HULL_TIME(TRIM_PHASE);
+		set.trim(set.size() - hullSize);
+	}
+	HULL_TIME(COORDINATE_SORT_PHASE);
+	set.sortSet(XCoordinateOrder());
+}
+
+
+/**
+ * Computes the convex hull of the given set with Andrew's monotone chain
+ * algorithm, leaving only the points of the hull in the set, sorted by
+ * coordinates. The chains are built over the set sorted by coordinates, and
+ * the hull is left in that same order, so no sort is needed afterwards.
+ */
+static void monotoneChainHull(PointSet& set)
+{
+	{
+		HULL_TIME(COORDINATE_SORT_PHASE);
+		set.sortSet(XCoordinateOrder());
+	}
+	int hullSize;
+	{
+		HULL_TIME(SCAN_PHASE);
+		hullSize = monotoneChainSort(set);
+	}
+	HULL_TIME(TRIM_PHASE);
+	set.trim(set.size() - hullSize);
+}
+
+/* ----------------------------- Chan's algorithm ------------------------------- */
+
+/** The group size of the first round of Chan's algorithm. Every failed round
+ * squares the group size */
+static const int CHAN_STARTING_GROUP_SIZE = 256;
+
+/** Returns the Manhattan distance between two points, which orders points on
+ * the same ray from a point like the real distance does */
+static long long manhattanDistance(const Point& p1, const Point& p2)
+{
+	return llabs((long long)p1.getX() - p2.getX()) + llabs((long long)p1.getY() - p2.getY());
+}
+
+
+/**
+ * Returns true iff the candidate is a better choice than the current point
+ * for the hull vertex following the given point, in counter clockwise order:
+ * the candidate is to the right of the line from the point to the current
+ * one, or on that line and farther away.
+ */
+static bool isBetterWrap(const Point& point, const Point& current, const Point& candidate)
+{
+	int turn = getTurnDirection(&point, &current, &candidate);
+	return turn < 0 or (turn == 0 and
+	                    manhattanDistance(point, candidate) > manhattanDistance(point, current));
+}
+
+
+/**
+ * Returns the index of the vertex of the given convex polygon, ordered counter
+ * clockwise and without collinear vertices, that all the polygon lies to the
+ * left of when seen from the given point, and the farthest such vertex when two
+ * lie on the same line from the point. The point must be outside the polygon.
+ * Seen from such a point, isBetterWrap orders the vertices, and the order
+ * rises along the polygon up to the tangent and falls from it back to the
+ * other tangent. The binary search keeps a chain of the polygon from low to
+ * high that holds the tangent strictly inside it, and picks the half that
+ * still does by the directions of the edges at low and at the middle.
+ */
+static int findTangent(const Point& point, const Point* hull, const int size)
+{
+	if(size < MINIMAL_POINTS_IN_HULL)
+	{
+		return (size == 2 and isBetterWrap(point, hull[0], hull[1])) ? 1 : 0;
+	}
+	if(isBetterWrap(point, hull[1], hull[0]) and !isBetterWrap(point, hull[0], hull[size - 1]))
+	{
+		return 0;
+	}
+
+	int low = 0;
+	int high = size;
+	while(true)
+	{
+		int middle = (low + high) / 2;
+		bool middleFalls = isBetterWrap(point, hull[(middle + 1) % size], hull[middle]);
+		if(middleFalls and !isBetterWrap(point, hull[middle], hull[middle - 1]))
+		{
+			return middle;
+		}
+
+		bool lowRises = isBetterWrap(point, hull[low], hull[low + 1]);
+		bool middleAboveLow = isBetterWrap(point, hull[low], hull[middle]);
+		if((lowRises and (middleFalls or !middleAboveLow)) or
+		   (!lowRises and middleFalls and middleAboveLow))
+		{
+			high = middle;
+		}
+		else
+		{
+			low = middle;
+		}
+		assert(high - low >= 2);
+	}
+}
+
+
+/**
+ * Replaces every run of the given number of consecutive group hulls by the
+ * hull of their union, computed with the Grahm Scan algorithm. The hulls are
+ * kept one after the other in a single array, the hull of group g spanning
+ * the indexes from groupStarts[g] to groupStarts[g + 1]. Each hull is left
+ * in counter clockwise order, starting with its lowest point.
+ */
+static void mergeGroupHulls(vector<Point>& groupHulls, vector<int>& groupStarts,
+                            const int groupsPerHull)
+{
+	vector<Point> mergedHulls;
+	vector<int> mergedStarts;
+	PointSet group;
+	int groups = groupStarts.size() - 1;
+	for(int first = 0; first < groups; first += groupsPerHull)
+	{
+		int last = min(groups, first + groupsPerHull);
+		for(int i = groupStarts[first]; i < groupStarts[last]; i++)
+		{
+			group.add(groupHulls[i]);
+		}
+		group.sortByKey(PolarAngleKeyFunction(*group.getMinimum(YCoordinateOrder())));
+		int hullSize = grahmScanSort(group);
+		const Point* hullPoints = group.getPoints();
+		mergedStarts.push_back(mergedHulls.size());
+		mergedHulls.insert(mergedHulls.end(), hullPoints, hullPoints + hullSize);
+		group.trim(group.size());
+	}
+	mergedStarts.push_back(mergedHulls.size());
+	groupHulls.swap(mergedHulls);
+	groupStarts.swap(mergedStarts);
+}
+
+
+/**
+ * Wraps the hull around the given group hulls, finding every vertex by the
+ * tangents from the previous vertex to all group hulls.
+ * @return True iff the hull was closed within the given number of vertices, in
+ * which case the hull is written to the given vector in counter clockwise order
+ */
+static bool wrapGroupHulls(const vector<Point>& groupHulls, const vector<int>& groupStarts,
+                           const int maximalHullSize, vector<Point>& hull)
+{
+	/* The lowest point of the whole set is the first vertex of its group hull,
+	 * and is the first vertex of the hull */
+	int groups = groupStarts.size() - 1;
+	int currentGroup = 0;
+	for(int g = 1; g < groups; g++)
+	{
+		const Point* candidate = &groupHulls[groupStarts[g]];
+		const Point* lowest = &groupHulls[groupStarts[currentGroup]];
+		if(yCoordinateComparator(candidate, lowest))
+		{
+			currentGroup = g;
+		}
+	}
+	const int firstGroup = currentGroup;
+	int currentIndex = 0;
+
+	hull.clear();
+	for(int step = 0; step < maximalHullSize; step++)
+	{
+		const Point& current = groupHulls[groupStarts[currentGroup] + currentIndex];
+		hull.push_back(current);
+
+		/* Within its own group, the point is followed by the next vertex of the
+		 * group hull. The other groups are only compared by their tangents */
+		int nextGroup = currentGroup;
+		int nextIndex = (currentIndex + 1) % (groupStarts[currentGroup + 1] -
+		                                      groupStarts[currentGroup]);
+		for(int g = 0; g < groups; g++)
+		{
+			if(g == currentGroup)
+			{
+				continue;
+			}
+			const Point* groupHull = &groupHulls[groupStarts[g]];
+			int tangent = findTangent(current, groupHull, groupStarts[g + 1] - groupStarts[g]);
+			if(isBetterWrap(current, groupHulls[groupStarts[nextGroup] + nextIndex],
+			                groupHull[tangent]))
+			{
+				nextGroup = g;
+				nextIndex = tangent;
+			}
+		}
+
+		if(nextGroup == firstGroup and nextIndex == 0)
+		{
+			return true;
+		}
+		currentGroup = nextGroup;
+		currentIndex = nextIndex;
+	}
+	return false;
+}
+
+
+/**
+ * Computes the convex hull of the given set with Chan's algorithm, leaving
+ * only the points of the hull in the set, sorted by coordinates. The set is
+ * divided into groups of m points, whose hulls are computed with the Grahm
+ * Scan algorithm, and the hull is gift wrapped around the group hulls, giving
+ * up after m vertices. The group size is squared until m is at least the size
+ * h of the hull, so the total cost is O(n log h). The groups of a round are
+ * unions of whole groups of the previous round, so their hulls are computed
+ * from the previous group hulls alone.
+ */
+static void chanHull(PointSet& set)
+{
+	HULL_TIME(CHAN_PHASE);
+	int n = set.size();
+	if(n == 0)
+	{
+		return;
+	}
+
+	const Point* points = set.getPoints();
+	vector<Point> groupHulls(points, points + n);
+	vector<int> groupStarts;
+	for(int start = 0; start < n; start += CHAN_STARTING_GROUP_SIZE)
+	{
+		groupStarts.push_back(start);
+	}
+	groupStarts.push_back(n);
+
+	vector<Point> hull;
+	int groupSize = min(CHAN_STARTING_GROUP_SIZE, n);
+	mergeGroupHulls(groupHulls, groupStarts, 1);
+	while(!wrapGroupHulls(groupHulls, groupStarts, groupSize, hull))
+	{
+		int nextGroupSize = (int)min((long long)groupSize * groupSize, (long long)n);
+		mergeGroupHulls(groupHulls, groupStarts, (nextGroupSize + groupSize - 1) / groupSize);
+		groupSize = nextGroupSize;
+	}
+
+	PointSet hullSet;
+	for(size_t i = 0; i < hull.size(); i++)
+	{
+		hullSet.add(hull[i]);
+	}
+	hullSet.sortSet(XCoordinateOrder());
+	set = move(hullSet);
+}
+
+
+/**
+ * Removes from the set every point that is strictly inside the polygon
+ * spanned by the extreme points of the set in 8 directions - the minimum and
+ * maximum of x, y, x + y and x - y (the Akl-Toussaint heuristic). The extreme
+ * points are on the hull, so the removed points can't be. The polygon vertices
+ * are taken counter clockwise, so a point is strictly inside iff it forms a
+ * left turn with every edge. For uniformly spread points, most of the set is
+ * removed, in a single linear pass.
+ * @return The number of points removed
+ */
+int cullInteriorPoints(PointSet& set)
+{
+	HULL_TIME(CULL_PHASE);
+	if(set.size() < MINIMAL_POINTS_IN_HULL)
+	{
+		return 0;
+	}
+
+	/* The directions are ordered counter clockwise, starting at the bottom */
+	const Point* points = set.getPoints();
+	ExtremeIndexes extremes;
+	findExtremes(points, set.size(), extremes);
+	const int directions[] = {
+		extremes.minY, extremes.maxDifference, extremes.maxX, extremes.maxSum,
+		extremes.maxY, extremes.minDifference, extremes.minX, extremes.minSum};
+
+	vector<Point> polygon;
+	for(size_t i = 0; i < sizeof(directions) / sizeof(directions[0]); i++)
+	{
+		const Point& extreme = points[directions[i]];
+		if(polygon.empty() or !(polygon.back() == extreme))
+		{
+			polygon.push_back(extreme);
+		}
+	}
+	while(polygon.size() > 1 and polygon.back() == polygon.front())
+	{
+		polygon.pop_back();
+	}
+	if(polygon.size() < (size_t)MINIMAL_POINTS_IN_HULL)
+	{
+		return 0;
+	}
+
+	/* The points are tested a block at a time against every edge, so that the
+	 * turns of a whole block are computed by the vectorized kernel */
+	vector<Point> survivors;
+	int size = polygon.size();
+	signed char turns[CULL_BLOCK_SIZE];
+	bool inside[CULL_BLOCK_SIZE];
+	for(int blockStart = 0; blockStart < set.size(); blockStart += CULL_BLOCK_SIZE)
+	{
+		const Point* block = points + blockStart;
+		int blockSize = min(CULL_BLOCK_SIZE, set.size() - blockStart);
+		for(int i = 0; i < blockSize; i++)
+		{
+			inside[i] = true;
+		}
+		for(int j = 0; j < size; j++)
+		{
+			orientBlock(polygon[j], polygon[(j + 1) % size], block, blockSize, turns);
+			for(int i = 0; i < blockSize; i++)
+			{
+				inside[i] = inside[i] and turns[i] > 0;
+			}
+		}
+		for(int i = 0; i < blockSize; i++)
+		{
+			if(!inside[i])
+			{
+				survivors.push_back(block[i]);
+			}
+		}
+	}
+
+	int culled = set.size() - survivors.size();
+	if(culled > 0)
+	{
+		PointSet survivorSet;
+		for(size_t i = 0; i < survivors.size(); i++)
+		{
+			survivorSet.add(survivors[i]);
+		}
+		set = move(survivorSet);
+	}
+	return culled;
+}
+
+
+/**
+ * Computes the convex hull of the given points with the monotone chain
+ * algorithm, and stores its points in the given vector. The given points are
+ * sorted in place.
+ */
+static void chunkHull(vector<Point>& points, vector<Point>& hull)
+{
+	sortPoints(points.data(), points.size(), XCoordinateOrder());
+	int n = points.size();
+	hull.clear();
+	if(n < MINIMAL_POINTS_IN_HULL)
+	{
+		hull = points;
+		return;
+	}
+
+	// Building the lower hull, and then the upper hull on top of it, so the
+	// hull ends up in counter clockwise order, starting at the first point.
+	hull.reserve(2 * n);
+	for(int pass = 0; pass < 2; pass++)
+	{
+		size_t chainStart = hull.size();
+		for(int j = 0; j < n; j++)
+		{
+			const Point& point = points[(pass == 0) ? j : n - 1 - j];
+			while(hull.size() >= chainStart + 2 and
+			      getTurnDirection(&hull[hull.size() - 2], &hull.back(), &point) <= 0)
+			{
+				hull.pop_back();
+				HULL_COUNT(SCAN_BACKTRACKS, 1);
+			}
+			hull.push_back(point);
+		}
+		// The last point of each chain is the first point of the next one
+		hull.pop_back();
+	}
+}
+
+
+/**
+ * Computes the convex hull of the given set by dividing it between the given
+ * number of threads. Every thread computes the hull of its chunk of the set
+ * with the monotone chain algorithm. The hull of the whole set is then the hull
+ * of the union of the local hulls, which is computed with the given engine.
+ */
+static void parallelHull(PointSet& set, const HullEngine engine, const int threads)
+{
+	const Point* points = set.getPoints();
+	int n = set.size();
+	vector< vector<Point> > localHulls(threads);
+	vector<thread> workers;
+	{
+		HULL_TIME(LOCAL_HULLS_PHASE);
+		for(int t = 0; t < threads; t++)
+		{
+			const Point* chunkStart = points + (long long)n * t / threads;
+			const Point* chunkEnd = points + (long long)n * (t + 1) / threads;
+			vector<Point>& localHull = localHulls[t];
+			workers.push_back(thread([chunkStart, chunkEnd, &localHull]()
+			{
+				vector<Point> chunk(chunkStart, chunkEnd);
+				chunkHull(chunk, localHull);
+				HULL_MERGE_THREAD_STATS();
+			}));
+		}
+		for(int t = 0; t < threads; t++)
+		{
+			workers[t].join();
+		}
+	}
+
+	/* The points of the set are unique, so the local hulls are disjoint */
+	PointSet candidates;
+	for(int t = 0; t < threads; t++)
+	{
+		for(size_t j = 0; j < localHulls[t].size(); j++)
+		{
+			candidates.add(localHulls[t][j]);
+		}
+	}
+	set = move(candidates);
+	computeHull(set, engine);
+}
+
+
+/**
+ * Computes the convex hull of the given set with the given engine. The set is
+ * left holding only the points of the hull, sorted by the x coordinate, and
+ * secondly by the y coordinate. If more than one thread is given, and the set
+ * is large enough, the set is first reduced to the union of the hulls of its
+ * chunks, computed concurrently.
+ */
+void computeHull(PointSet& set, const HullEngine engine, const int threads)
+{
+	int usedThreads = min(threads, set.size() / MINIMAL_POINTS_PER_THREAD);
+	if(usedThreads > 1)
+	{
+		parallelHull(set, engine, usedThreads);
+		return;
+	}
+
+	switch(engine)
+	{
+		case MONOTONE_CHAIN:
+			monotoneChainHull(set);
+			break;
+
+		case CHAN_ALGORITHM:
+			chanHull(set);
+			break;
+
+		case GRAHAM_SCAN:
+		default:
+			grahmScanHull(set);
+			break;
+	}
+}
+
+
+/**
+ * Looks up the engine with the given name ("graham", "monotone" or "chan").
+ * @return True iff such an engine exists
+ */
+bool getEngineByName(const string& name, HullEngine& engine)
+{
+	if(name == "graham")
+	{
+		engine = GRAHAM_SCAN;
+		return true;
+	}
+	if(name == "monotone")
+	{
+		engine = MONOTONE_CHAIN;
+		return true;
+	}
+	if(name == "chan")
+	{
+		engine = CHAN_ALGORITHM;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,121 @@
+// HullAlgorithms.h
+#ifndef HULL_ALGORITHMS_H
+#define HULL_ALGORITHMS_H
+
+#include <string>
+#include "Point.h"
+#include "PointSet.h"
+
+using namespace std;
+
+/**
+ * The algorithms available for computing the convex hull of a PointSet.
+ */
+enum HullEngine
+{
+	GRAHAM_SCAN,
+	MONOTONE_CHAIN,
+	CHAN_ALGORITHM
+};
+
+
+/**
+ * The key by which points are sorted according to their polar angle around a
+ * pivot. The key holds the vector from the pivot to the point, and is compared
+ * exactly, using only integer arithmetic: first by the half plane the vector
+ * lies in (the pivot itself coming before both), then by the sign of the cross
+ * product of the two vectors, and finally, for vectors in the same direction,
+ * by their length. With the pivot being the lowest point, all other points lie
+ * in the upper half plane, so the points are ordered counter clockwise starting
+ * from the positive x axis, with closer points first on the same ray.
+ */
+class PolarAngleKey
+{
+public:
+	/**
+	 * Constructs the key of the given point around the given pivot
+	 */
+	PolarAngleKey(const Point& point, const Point& pivot);
+
+	/**
+	 * Returns true iff this key comes before the given key
+	 */
+	bool operator<(const PolarAngleKey& other) const;
+
+private:
+	long long _dx;
+	long long _dy;
+	int _halfPlane;
+};
+
+
+/** Function object computing the PolarAngleKey of points around a fixed
+ * pivot. To be used with PointSet::sortByKey. */
+class PolarAngleKeyFunction
+{
+public:
+	/**
+	 * Constructs a key function around the given pivot. The pivot is copied,
+	 * so it may be a point within the sorted set.
+	 */
+	PolarAngleKeyFunction(const Point& pivot);
+
+	/**
+	 * Returns the key of the given point
+	 */
+	PolarAngleKey operator()(const Point& point) const;
+
+private:
+	const Point _pivot;
+};
+
+
+/** 
+ * Checks what turn is formed with the line between the three given points.
+ * Returns a positive number for a left turn, a negative for a right turn, and
+ * 0 if all points are on the same line. Exact for integer coordinates of up to
+ * 64 bits, and rounded for floating coordinates.
+ */
+template <typename Coordinate>
+int getTurnDirection(const BasicPoint<Coordinate>* p1, const BasicPoint<Coordinate>* p2,
+                     const BasicPoint<Coordinate>* p3);
+
+/** Receives a PointSet object with a pivot point located at the start of the
+ * set, followed by the rest of the points sorted by their polar angle around
+ * it. Moves the points of the convex hull to the first M places of the set,
+ * using the Grahm Scan algorithm, and returns M.
+ */
+int grahmScanSort(PointSet& set);
+
+/** Receives a PointSet object sorted by the x coordinate, and secondly by the
+ * y coordinate. Moves the points of the convex hull to the first M places of
+ * the set, keeping them sorted, using Andrew's monotone chain algorithm, and
+ * returns M.
+ */
+int monotoneChainSort(PointSet& set);
+
+/**
+ * Removes from the set every point that is strictly inside the polygon
+ * spanned by the extreme points of the set in 8 directions (the Akl-Toussaint
+ * heuristic). Such points can't be on the hull, so this may be run before
+ * computing the hull, to reduce the number of points it has to sort.
+ * @return The number of points removed
+ */
+int cullInteriorPoints(PointSet& set);
+
+/**
+ * Computes the convex hull of the given set with the given engine. The set is
+ * left holding only the points of the hull, sorted by the x coordinate, and
+ * secondly by the y coordinate. With more than one thread, the set is divided
+ * into chunks whose hulls are computed concurrently, and the given engine
+ * computes the hull of the union of those hulls.
+ */
+void computeHull(PointSet& set, const HullEngine engine, const int threads = 1);
+
+/**
+ * Looks up the engine with the given name ("graham", "monotone" or "chan").
+ * @return True iff such an engine exists
+ */
+bool getEngineByName(const string& name, HullEngine& engine);
+
+#endif
@@ -0,0 +1,80 @@
+// HullStats.cpp
+#include "HullStats.h"
+#include <cstring>
+#include <ostream>
+#include <mutex>
+
+using namespace std;
+
+// --------------------------------------------------------------------------------------
+// This file contains the totals of the instrumentation of the hull pipeline,
+// and their printing.
+// --------------------------------------------------------------------------------------
+
+/* The names of the phases and counters in the JSON output, in the order of
+ * their enums */
+static const char* const PHASE_NAMES[PHASE_COUNT] = {"parse", "add", "cull", "minimum", "polar_sort",
+                                                     "scan", "trim", "coordinate_sort", "chan",
+                                                     "local_hulls", "output"};
+static const char* const COUNTER_NAMES[COUNTER_COUNT] = {"polar_comparisons", "scan_backtracks",
+                                                         "array_reallocations", "index_rehashes",
+                                                         "bytes_read", "bytes_written"};
+
+static HullStats totalHullStats;
+static mutex totalHullStatsLock;
+
+#ifdef HULL_STATS
+thread_local HullStats threadHullStats;
+#endif
+
+
+/** Returns true iff the instrumentation is compiled in */
+bool hullStatsEnabled()
+{
+#ifdef HULL_STATS
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+/** Merges the record of the running thread into the totals, and resets it.
+ * Does nothing if the instrumentation is compiled out. */
+void mergeThreadHullStats()
+{
+#ifdef HULL_STATS
+	lock_guard<mutex> guard(totalHullStatsLock);
+	for(int phase = 0; phase < PHASE_COUNT; phase++)
+	{
+		totalHullStats.seconds[phase] += threadHullStats.seconds[phase];
+		totalHullStats.calls[phase] += threadHullStats.calls[phase];
+	}
+	for(int counter = 0; counter < COUNTER_COUNT; counter++)
+	{
+		totalHullStats.counts[counter] += threadHullStats.counts[counter];
+	}
+	memset(&threadHullStats, 0, sizeof(threadHullStats));
+#endif
+}
+
+
+/** Writes the totals as a JSON object on a single line */
+void printHullStats(ostream& output)
+{
+	mergeThreadHullStats();
+	lock_guard<mutex> guard(totalHullStatsLock);
+	output << "{\"phases\": {";
+	for(int phase = 0; phase < PHASE_COUNT; phase++)
+	{
+		output << (phase == 0 ? "" : ", ") << "\"" << PHASE_NAMES[phase] << "\": {\"seconds\": "
+		       << totalHullStats.seconds[phase] << ", \"calls\": " << totalHullStats.calls[phase] << "}";
+	}
+	output << "}, \"counters\": {";
+	for(int counter = 0; counter < COUNTER_COUNT; counter++)
+	{
+		output << (counter == 0 ? "" : ", ") << "\"" << COUNTER_NAMES[counter] << "\": "
+		       << totalHullStats.counts[counter];
+	}
+	output << "}}" << endl;
+}
@@ -0,0 +1,124 @@
+// HullStats.h
+#ifndef HULL_STATS_H
+#define HULL_STATS_H
+
+#include <iosfwd>
+
+using namespace std;
+
+/**
+ * The instrumentation of the hull pipeline: timers of its phases, and counters
+ * of the events that explain them. It is compiled in when HULL_STATS is
+ * defined, as it is by the Makefile, and compiled out otherwise, leaving the
+ * HULL_TIME and HULL_COUNT macros empty, so that it costs nothing.
+ *
+ * Every thread counts into a plain thread local record, so the counters don't
+ * synchronize. A thread other than the main one merges its record into the
+ * totals when it is done, with HULL_MERGE_THREAD_STATS. The time of a phase
+ * run by several threads at once is summed over them, and a phase nested in
+ * another is counted in both.
+ */
+
+/** The timed phases of the hull pipeline */
+enum HullPhase
+{
+	PARSE_PHASE, // Reading and parsing the input
+	ADD_PHASE, // Adding the points read to the set
+	CULL_PHASE,
+	MINIMUM_PHASE, // Finding the pivot of the Grahm Scan
+	POLAR_SORT_PHASE,
+	SCAN_PHASE, // The scan of the Grahm Scan or the monotone chain
+	TRIM_PHASE, // Removing the points not on the hull from the set
+	COORDINATE_SORT_PHASE,
+	CHAN_PHASE,
+	LOCAL_HULLS_PHASE, // The hulls of the chunks of the threads
+	OUTPUT_PHASE,
+	PHASE_COUNT
+};
+
+/** The counted events of the hull pipeline */
+enum HullCounter
+{
+	POLAR_COMPARISONS, // Comparisons of points by their polar angles
+	SCAN_BACKTRACKS, // Points popped by the scans
+	ARRAY_REALLOCATIONS, // Reallocations of the arrays of the sets
+	INDEX_REHASHES, // Growths of the hash indexes of the sets
+	BYTES_READ,
+	BYTES_WRITTEN,
+	COUNTER_COUNT
+};
+
+/** The timers and counters of a thread, or their totals */
+struct HullStats
+{
+	double seconds[PHASE_COUNT];
+	long long calls[PHASE_COUNT];
+	long long counts[COUNTER_COUNT];
+};
+
+#ifdef HULL_STATS
+
+#include <chrono>
+
+/** The record of the running thread. Zero initialized, with no constructor or
+ * destructor, so that it is reached without a guard. */
+extern thread_local HullStats threadHullStats;
+
+/**
+ * Times the phase it is constructed with, from its construction to its
+ * destruction, in the record of its thread
+ */
+class PhaseTimer
+{
+public:
+	PhaseTimer(const HullPhase phase): _phase(phase), _start(chrono::steady_clock::now()){}
+
+	~PhaseTimer()
+	{
+		chrono::duration<double> elapsed = chrono::steady_clock::now() - _start;
+		threadHullStats.seconds[_phase] += elapsed.count();
+		threadHullStats.calls[_phase]++;
+	}
+
+private:
+	const HullPhase _phase;
+	const chrono::steady_clock::time_point _start;
+
+	PhaseTimer(const PhaseTimer&);
+	PhaseTimer& operator=(const PhaseTimer&);
+};
+
+#define HULL_STATS_CONCATENATE(a, b) a##b
+#define HULL_STATS_NAME(line) HULL_STATS_CONCATENATE(phaseTimer, line)
+
+/** Times the given phase until the end of the enclosing scope */
+#define HULL_TIME(phase) PhaseTimer HULL_STATS_NAME(__LINE__)(phase)
+
+/** Adds the given number to the given counter */
+#define HULL_COUNT(counter, n) (threadHullStats.counts[counter] += (n))
+
+/** Merges the record of the running thread into the totals */
+#define HULL_MERGE_THREAD_STATS() mergeThreadHullStats()
+
+#else
+
+#define HULL_TIME(phase) ((void)0)
+#define HULL_COUNT(counter, n) ((void)0)
+#define HULL_MERGE_THREAD_STATS() ((void)0)
+
+#endif
+
+/** Returns true iff the instrumentation is compiled in */
+bool hullStatsEnabled();
+
+/** Merges the record of the running thread into the totals, and resets it */
+void mergeThreadHullStats();
+
+/**
+ * Writes the totals as a JSON object, merging the record of the running
+ * thread first: the seconds and number of runs of every phase, and every
+ * counter
+ */
+void printHullStats(ostream& output);
+
+#endif
@@ -2,28 +2,25 @@
 
 #include "Point.h"
 #include <string>
-#include <sstream>
+#include <cstdio>
 
 using namespace std;
 
 // -------------------------------------------------------------------------------
-// This file contains the implementation of the class Point.
+// This file contains the implementation of the class BasicPoint.
 // -------------------------------------------------------------------------------
 
 /**
  * Constructor with given coordinates
  */
-Point::Point(const int x, const int y): _x(x), _y(y){}
-
-/**
- * Copy constructor
- */
-Point::Point(const Point& point): _x(point.getX()), _y(point.getY()){}
+template <typename Coordinate>
+BasicPoint<Coordinate>::BasicPoint(const Coordinate x, const Coordinate y): _x(x), _y(y){}
 
 /**
  * Getter for the x coordinate
  */
-int Point::getX() const
+template <typename Coordinate>
+Coordinate BasicPoint<Coordinate>::getX() const
 {
 	return _x;
 }
@@ -31,7 +28,8 @@ int Point::getX() const
 /**
  * Getter for the y coordinate
  */
-int Point::getY() const
+template <typename Coordinate>
+Coordinate BasicPoint<Coordinate>::getY() const
 {
 	return _y;
 }
@@ -39,24 +37,108 @@ int Point::getY() const
 /**
  * Sets the coordinates to given values
  */
-void Point::set(const int x, const int y)
+template <typename Coordinate>
+void BasicPoint<Coordinate>::set(const Coordinate x, const Coordinate y)
 {
 	_x = x;
 	_y = y;
 }
 
+/* The decimal digits of the numbers 0 to 99, in pairs, so that integers are
+ * converted two digits at a time */
+static const char DIGIT_PAIRS[] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/**
+ * Writes the given integer coordinate in decimal to the given buffer. The
+ * digits are found from the last, two at a time, into a scratch buffer, and
+ * copied once. The magnitude is taken as unsigned, so the most negative value
+ * is written as well.
+ */
+template <typename Coordinate>
+static char* formatCoordinate(char* output, const Coordinate coordinate, true_type)
+{
+	typedef typename make_unsigned<Coordinate>::type Magnitude;
+	Magnitude magnitude = (Magnitude)coordinate;
+	if(coordinate < 0)
+	{
+		*output++ = '-';
+		magnitude = (Magnitude)(0 - magnitude);
+	}
+
+	char digits[numeric_limits<Magnitude>::digits10 + 1];
+	char* const digitsEnd = digits + sizeof(digits);
+	char* start = digitsEnd;
+	while(magnitude >= 100)
+	{
+		const int pair = (int)(magnitude % 100) * 2;
+		magnitude /= 100;
+		*--start = DIGIT_PAIRS[pair + 1];
+		*--start = DIGIT_PAIRS[pair];
+	}
+	if(magnitude >= 10)
+	{
+		*--start = DIGIT_PAIRS[magnitude * 2 + 1];
+		*--start = DIGIT_PAIRS[magnitude * 2];
+	}
+	else
+	{
+		*--start = (char)('0' + magnitude);
+	}
+	memcpy(output, start, digitsEnd - start);
+	return output + (digitsEnd - start);
+}
+
+/**
+ * Writes the given floating coordinate to the given buffer, with as many
+ * digits as it takes to read it back unchanged. It is written to a scratch
+ * buffer first, which takes the null character of snprintf.
+ */
+template <typename Coordinate>
+static char* formatCoordinate(char* output, const Coordinate coordinate, false_type)
+{
+	char text[CoordinateTraits<Coordinate>::maxTextLength + 1];
+	int length = snprintf(text, sizeof(text), "%.*g", numeric_limits<Coordinate>::max_digits10,
+	                      (double)coordinate);
+	memcpy(output, text, length);
+	return output + length;
+}
+
 /**
- * Returns the coordinates of the point as a string
+ * Writes the coordinates of the point to the given buffer, in the same format
+ * as toString()
  */
-string Point::toString() const
+template <typename Coordinate>
+char* BasicPoint<Coordinate>::format(char* output) const
 {
-	ostringstream output;
-	output << _x << "," << _y;
-	return output.str();
+	integral_constant<bool, CoordinateTraits<Coordinate>::isExact> exact;
+	output = formatCoordinate(output, _x, exact);
+	*output++ = ',';
+	return formatCoordinate(output, _y, exact);
+}
+
+/**
+ * Returns the coordinates of the point as a string. Floating coordinates are
+ * written with as many digits as it takes to read them back unchanged.
+ */
+template <typename Coordinate>
+string BasicPoint<Coordinate>::toString() const
+{
+	char text[MAX_TEXT_LENGTH];
+	return string(text, format(text));
 }
 
 /** Two points are equal if they have the same coordinates */
-bool Point::operator==(const Point &other) const
+template <typename Coordinate>
+bool BasicPoint<Coordinate>::operator==(const BasicPoint &other) const
 {
 	return _x == other.getX() and _y == other.getY();
 }
+
+
+template class BasicPoint<int16_t>;
+template class BasicPoint<int32_t>;
+template class BasicPoint<int64_t>;
+template class BasicPoint<double>;
@@ -3,60 +3,151 @@
 #define POINT_H
 
 #include <string>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 
 using namespace std;
+
 /**
- * This class represents a single point in a two dimensional space, with (x,y)
- * coordinates.
+ * The properties of a type of coordinates, known at compile time, by which
+ * points of that type are hashed, sorted and checked for turns. Points can be
+ * held with coordinates of the types int16_t, int32_t, int64_t and double.
  */
+template <typename Coordinate>
+struct CoordinateTraits
+{
+	/** True iff the coordinates are integers, so computations over them can
+	 * be exact. Floating coordinates are computed with as they are rounded. */
+	static const bool isExact = numeric_limits<Coordinate>::is_integer;
 
-class Point
+	/** True iff the coordinates are integers of at most 32 bits, so that both
+	 * coordinates of a point fit in 64 bits as they are */
+	static const bool isNarrow = isExact and sizeof(Coordinate) <= sizeof(int32_t);
+
+	/** The most characters taken by the text of a coordinate: the digits and
+	 * sign of an integer, or a double written with 17 significant digits, as
+	 * in "-2.2250738585072014e-308" */
+	static const int maxTextLength = isExact ? numeric_limits<Coordinate>::digits10 + 2 : 24;
+};
+
+/**
+ * This class represents a single point in a two dimensional space, with (x,y)
+ * coordinates of the given type.
+ */
+template <typename Coordinate>
+class BasicPoint
 {
 public:
 
 	/**
 	 * Constructor with given coordinates
 	 */
-	Point(const int x, const int y);
+	BasicPoint(const Coordinate x, const Coordinate y);
 
 	/**
-	 * Copy constructor
+	 * Copy constructor. Left trivial, so that sets can copy and move their
+	 * points around as plain memory.
 	 */
-	Point(const Point& point);
+	BasicPoint(const BasicPoint& point) = default;
 
-	/** 
+	/**
 	 * Sets the coordinates to given values
 	 */
-	void set(const int x, const int y);
+	void set(const Coordinate x, const Coordinate y);
 
 	/**
 	 * Getter for the x coordinate.
 	 * @return The x coordinate
 	 */
-	int getX() const;
+	Coordinate getX() const;
 
 	/**
 	 * Getter for the y coordinate
 	 * @return The y coordinate
 	 */
-	int getY() const; 
-	
+	Coordinate getY() const;
+
 	/**
 	 * Returns the coordinates as a string in the format "<x>,<y>"
 	 */
 	string toString() const;
 
-	/** 
+	/**
+	 * Writes the coordinates in the format of toString() to the given buffer,
+	 * without allocating, and without a terminating null character.
+	 * @param output A buffer of at least MAX_TEXT_LENGTH characters
+	 * @return The end of the text written
+	 */
+	char* format(char* output) const;
+
+	/**
 	 * Two points are equal if they have the same coordinates
 	 */
-	bool operator==(const Point &other) const;
+	bool operator==(const BasicPoint &other) const;
+
+	/** The most characters taken by the text of a point, "<x>,<y>" */
+	static const int MAX_TEXT_LENGTH = 2 * CoordinateTraits<Coordinate>::maxTextLength + 1;
 
 
 private:
 
-	int _x;
-	int _y;
-	
+	Coordinate _x;
+	Coordinate _y;
+
 };
-	
-#endif 
+
+/** The points used by the hull algorithms, with int coordinates */
+typedef BasicPoint<int32_t> Point;
+
+
+/**
+ * Returns 64 bits standing for the given coordinate, which are the same for
+ * equal coordinates
+ */
+template <typename Coordinate>
+inline uint64_t coordinateBits(const Coordinate coordinate)
+{
+	return (uint64_t)(int64_t)coordinate;
+}
+
+/**
+ * Returns 64 bits standing for the given floating coordinate. Adding zero
+ * turns -0.0 into 0.0, so that the two equal zeros have the same bits.
+ */
+inline uint64_t coordinateBits(const double coordinate)
+{
+	double normalized = coordinate + 0.0;
+	uint64_t bits;
+	memcpy(&bits, &normalized, sizeof(bits));
+	return bits;
+}
+
+/** Packs narrow coordinates into a 64 bit key as they are */
+template <typename Coordinate>
+inline uint64_t packCoordinates(const Coordinate x, const Coordinate y, true_type)
+{
+	return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+/** Mixes the bits of wide coordinates into a 64 bit key */
+template <typename Coordinate>
+inline uint64_t packCoordinates(const Coordinate x, const Coordinate y, false_type)
+{
+	uint64_t key = coordinateBits(x) * 0x9e3779b97f4a7c15ULL;
+	return (key ^ (key >> 32)) ^ coordinateBits(y);
+}
+
+/**
+ * Returns a 64 bit key of the given coordinates, the same for equal points,
+ * to be hashed. Narrow coordinates are packed as they are, so that their keys
+ * are distinct, and wider coordinates are mixed.
+ */
+template <typename Coordinate>
+inline uint64_t packCoordinates(const Coordinate x, const Coordinate y)
+{
+	return packCoordinates(x, y, integral_constant<bool, CoordinateTraits<Coordinate>::isNarrow>());
+}
+
+#endif
@@ -0,0 +1,116 @@
+// PointConverter.cpp
+
+/* This program converts a list of points between the text format read by
+ * ConvexHull, one "<x>,<y>" point per line, and the binary point file format
+ * described in PointFile.h. The points are read from the given file, or from
+ * the standard input if no file is given, and are written to the standard
+ * output in the same order, repeated points included. Text is converted to a
+ * binary point file, and with the --to-text option a binary point file is
+ * converted back to text.
+ */
+#include "Point.h"
+#include "PointReader.h"
+#include "PointFile.h"
+#include "PointWriter.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char* const USAGE = "Usage: PointConverter [--to-text] [input file]";
+
+/**
+ * Writes the points of the given text input as a binary point file. Malformed
+ * lines are reported and skipped by the reader.
+ * @return True iff all the lines were valid and the file was written
+ */
+static bool textToBinary(const int fd)
+{
+	PointReader reader(fd);
+	vector<Point> points;
+	int x, y;
+	while(reader.next(x, y))
+	{
+		points.push_back(Point(x, y));
+	}
+	if(!writePointFile(STDOUT_FILENO, points.data(), (int)points.size()))
+	{
+		cerr << "Cannot write the point file" << endl;
+		return false;
+	}
+	return reader.errorCount() == 0;
+}
+
+/**
+ * Writes the points of the given binary point file as text, one point per
+ * line
+ * @return True iff the file was valid and held 32 bit integer coordinates,
+ * and the points were written
+ */
+static bool binaryToText(const int fd)
+{
+	PointFile file;
+	if(!file.map(fd))
+	{
+		return false;
+	}
+	if(!file.holds<int>())
+	{
+		cerr << "The point file doesn't hold 32 bit integer coordinates" << endl;
+		return false;
+	}
+
+	PointWriter writer(STDOUT_FILENO);
+	writer.write(file.points<int>(), file.size());
+	if(!writer.flush())
+	{
+		cerr << "Cannot write the points" << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Main function - converts the input and writes it to the standard output.
+ * Returns 1 if the arguments were invalid, the input couldn't be opened or
+ * converted, or it had malformed lines.
+ */
+int main(int argc, char* argv[])
+{
+	bool toText = false;
+	const char* inputFile = nullptr;
+	for(int i = 1; i < argc; i++)
+	{
+		string argument = argv[i];
+		if(argument == "--to-text")
+		{
+			toText = true;
+		}
+		else if(argument.compare(0, 2, "--") != 0 and inputFile == nullptr)
+		{
+			inputFile = argv[i];
+		}
+		else
+		{
+			cerr << USAGE << endl;
+			return 1;
+		}
+	}
+
+	int fd = STDIN_FILENO;
+	if(inputFile != nullptr and (fd = open(inputFile, O_RDONLY)) < 0)
+	{
+		cerr << "Cannot open input file " << inputFile << endl;
+		return 1;
+	}
+
+	bool converted = toText ? binaryToText(fd) : textToBinary(fd);
+	if(fd != STDIN_FILENO)
+	{
+		close(fd);
+	}
+	return converted ? 0 : 1;
+}
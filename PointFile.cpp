@@ -0,0 +1,308 @@
+// PointFile.cpp
+#include "PointFile.h"
+#include "PointWriter.h"
+#include "HullStats.h"
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <type_traits>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+// --------------------------------------------------------------------------------------
+// This file contains the implementation of the class PointFile, and of the
+// writing of binary point files.
+// --------------------------------------------------------------------------------------
+
+static_assert(sizeof(PointFileHeader) == 64, "The header of a point file takes 64 bytes");
+
+/* Input that can't be mapped is read into a buffer starting at 1MB, which
+ * doubles in size whenever it fills up */
+static const size_t READ_BLOCK_SIZE = 1 << 20;
+static const int BUFFER_INCREASE_FACTOR = 2;
+
+/**
+ * Default Constructor, of an object not mapping any file
+ */
+PointFile::PointFile():_mapping(nullptr), _mappingLength(0), _mapped(false){}
+
+
+/**
+ * Destructor
+ */
+PointFile::~PointFile()
+{
+	if(_mapped)
+	{
+		munmap(_mapping, _mappingLength);
+	}
+	else
+	{
+		free(_mapping);
+	}
+}
+
+
+/** Returns true iff the given descriptor is of a regular file starting with
+ * the magic of a binary point file. The magic is read with pread, so the
+ * offset of the descriptor stays where it was. */
+bool PointFile::isPointFile(const int fd)
+{
+	struct stat status;
+	if(fstat(fd, &status) != 0 or !S_ISREG(status.st_mode) or
+	   status.st_size < (off_t)sizeof(PointFileHeader))
+	{
+		return false;
+	}
+
+	char magic[sizeof(POINT_FILE_MAGIC)];
+	return pread(fd, magic, sizeof(magic), 0) == (ssize_t)sizeof(magic) and
+	       memcmp(magic, POINT_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+
+/** Maps the binary point file of the given descriptor. The mapping is private,
+ * so writing to the points copies their pages instead of changing the file.
+ * Input that can't be mapped is read whole into a buffer instead. */
+bool PointFile::map(const int fd)
+{
+	struct stat status;
+	if(fstat(fd, &status) != 0 or !S_ISREG(status.st_mode))
+	{
+		return _read(fd) and _validate();
+	}
+	if(status.st_size < (off_t)sizeof(PointFileHeader))
+	{
+		cerr << "Not a point file" << endl;
+		return false;
+	}
+
+	_mappingLength = status.st_size;
+	_mapping = mmap(nullptr, _mappingLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	if(_mapping == MAP_FAILED)
+	{
+		_mapping = nullptr;
+		cerr << "Cannot map the point file" << endl;
+		return false;
+	}
+	_mapped = true;
+	madvise(_mapping, _mappingLength, MADV_SEQUENTIAL);
+	HULL_COUNT(BYTES_READ, _mappingLength);
+	return _validate();
+}
+
+
+/** Reads the whole input of the given descriptor into a buffer, which grows
+ * by doubling as the input is read */
+bool PointFile::_read(const int fd)
+{
+	size_t bufferSize = READ_BLOCK_SIZE;
+	if((_mapping = malloc(bufferSize)) == nullptr)
+	{
+		exit(1);
+	}
+
+	ssize_t bytesRead;
+	while(true)
+	{
+		if(_mappingLength == bufferSize)
+		{
+			bufferSize *= BUFFER_INCREASE_FACTOR;
+			if((_mapping = realloc(_mapping, bufferSize)) == nullptr)
+			{
+				exit(1);
+			}
+		}
+		bytesRead = read(fd, (char*)_mapping + _mappingLength, bufferSize - _mappingLength);
+		if(bytesRead < 0 and errno == EINTR)
+		{
+			continue;
+		}
+		if(bytesRead <= 0)
+		{
+			break;
+		}
+		_mappingLength += bytesRead;
+		HULL_COUNT(BYTES_READ, bytesRead);
+	}
+
+	if(bytesRead < 0 or _mappingLength < sizeof(PointFileHeader))
+	{
+		cerr << "Not a point file" << endl;
+		return false;
+	}
+	return true;
+}
+
+
+/** Checks the header of the mapped file against its length. The count is
+ * limited to the number of points a set can hold. */
+bool PointFile::_validate() const
+{
+	const PointFileHeader& fileHeader = header();
+	if(memcmp(fileHeader.magic, POINT_FILE_MAGIC, sizeof(POINT_FILE_MAGIC)) != 0)
+	{
+		cerr << "Not a point file" << endl;
+		return false;
+	}
+	if(fileHeader.version != POINT_FILE_VERSION)
+	{
+		cerr << "Unsupported point file version " << fileHeader.version << endl;
+		return false;
+	}
+	if(fileHeader.byteOrder != POINT_FILE_BYTE_ORDER)
+	{
+		cerr << "The point file was written in another byte order" << endl;
+		return false;
+	}
+
+	int width = fileHeader.coordinateWidth;
+	bool validWidth = (width == 2 or width == 4 or width == 8);
+	if(!(fileHeader.coordinateKind == INTEGER_COORDINATES and validWidth) and
+	   !(fileHeader.coordinateKind == FLOATING_COORDINATES and width == sizeof(double)))
+	{
+		cerr << "Unsupported coordinates in the point file" << endl;
+		return false;
+	}
+	if(fileHeader.count > (uint64_t)INT_MAX)
+	{
+		cerr << "The point file holds more points than supported" << endl;
+		return false;
+	}
+	if(_mappingLength != sizeof(PointFileHeader) + fileHeader.count * 2 * width)
+	{
+		cerr << "The length of the point file doesn't match its count of points" << endl;
+		return false;
+	}
+	return true;
+}
+
+
+/** Returns the header of the mapped file */
+const PointFileHeader& PointFile::header() const
+{
+	return *(const PointFileHeader*)_mapping;
+}
+
+
+/** Returns the number of points in the mapped file */
+int PointFile::size() const
+{
+	return (int)header().count;
+}
+
+
+/** Returns the kind of the given coordinate type */
+template <typename Coordinate>
+static CoordinateKind kindOf()
+{
+	return CoordinateTraits<Coordinate>::isExact ? INTEGER_COORDINATES : FLOATING_COORDINATES;
+}
+
+
+/** Returns true iff the coordinates of the mapped file are of the given type */
+template <typename Coordinate>
+bool PointFile::holds() const
+{
+	return header().coordinateWidth == sizeof(Coordinate) and
+	       header().coordinateKind == kindOf<Coordinate>();
+}
+
+
+/** Returns the points of the mapped file, which follow its header */
+template <typename Coordinate>
+BasicPoint<Coordinate>* PointFile::points() const
+{
+	if(!holds<Coordinate>())
+	{
+		return nullptr;
+	}
+	return (BasicPoint<Coordinate>*)((char*)_mapping + sizeof(PointFileHeader));
+}
+
+
+/** Sets the given bound to an integer coordinate */
+template <typename Coordinate>
+static void setBound(PointFileHeader::Bound& bound, const Coordinate coordinate, true_type)
+{
+	bound.integer = coordinate;
+}
+
+
+/** Sets the given bound to a floating coordinate */
+template <typename Coordinate>
+static void setBound(PointFileHeader::Bound& bound, const Coordinate coordinate, false_type)
+{
+	bound.floating = coordinate;
+}
+
+
+/** Sets the given bound to the given coordinate, by its kind */
+template <typename Coordinate>
+static void setBound(PointFileHeader::Bound& bound, const Coordinate coordinate)
+{
+	setBound(bound, coordinate, integral_constant<bool, CoordinateTraits<Coordinate>::isExact>());
+}
+
+
+/**
+ * Writes the given points as a binary point file. The bounding box is found in
+ * a single pass, and the points are then written as they are held, since a
+ * point consists of its two coordinates alone.
+ */
+template <typename Coordinate>
+bool writePointFile(const int fd, const BasicPoint<Coordinate>* points, const int n)
+{
+	static_assert(sizeof(BasicPoint<Coordinate>) == 2 * sizeof(Coordinate),
+	              "A point is written as its two coordinates");
+
+	PointFileHeader fileHeader;
+	memset(&fileHeader, 0, sizeof(fileHeader));
+	memcpy(fileHeader.magic, POINT_FILE_MAGIC, sizeof(POINT_FILE_MAGIC));
+	fileHeader.version = POINT_FILE_VERSION;
+	fileHeader.byteOrder = POINT_FILE_BYTE_ORDER;
+	fileHeader.coordinateWidth = sizeof(Coordinate);
+	fileHeader.coordinateKind = kindOf<Coordinate>();
+	fileHeader.count = n;
+
+	if(n > 0)
+	{
+		Coordinate minX = points[0].getX();
+		Coordinate minY = points[0].getY();
+		Coordinate maxX = minX;
+		Coordinate maxY = minY;
+		for(int i = 1; i < n; i++)
+		{
+			minX = min(minX, points[i].getX());
+			minY = min(minY, points[i].getY());
+			maxX = max(maxX, points[i].getX());
+			maxY = max(maxY, points[i].getY());
+		}
+		setBound(fileHeader.minX, minX);
+		setBound(fileHeader.minY, minY);
+		setBound(fileHeader.maxX, maxX);
+		setBound(fileHeader.maxY, maxY);
+	}
+
+	PointWriter writer(fd);
+	writer.write((const char*)&fileHeader, sizeof(fileHeader));
+	writer.write((const char*)points, sizeof(BasicPoint<Coordinate>) * n);
+	return writer.flush();
+}
+
+
+#define INSTANTIATE_POINT_FILE(Coordinate) \
+	template bool PointFile::holds<Coordinate>() const; \
+	template BasicPoint<Coordinate>* PointFile::points<Coordinate>() const; \
+	template bool writePointFile(const int fd, const BasicPoint<Coordinate>* points, const int n);
+
+INSTANTIATE_POINT_FILE(int16_t)
+INSTANTIATE_POINT_FILE(int32_t)
+INSTANTIATE_POINT_FILE(int64_t)
+INSTANTIATE_POINT_FILE(double)
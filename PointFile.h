@@ -0,0 +1,146 @@
+// PointFile.h
+#ifndef POINT_FILE_H
+#define POINT_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "Point.h"
+
+/**
+ * The binary point file format. A file consists of a 64 byte header followed
+ * by the coordinates of its points, packed in pairs: x0, y0, x1, y1 and so on.
+ * All fields are in the byte order of the machine that wrote the file, which
+ * is marked by the byteOrder field.
+ *
+ * offset  size  field
+ *  0       8    magic            "PNTFILE\0"
+ *  8       2    version          POINT_FILE_VERSION
+ * 10       2    byteOrder        POINT_FILE_BYTE_ORDER as written
+ * 12       1    coordinateWidth  The size of every coordinate in bytes: 2, 4 or 8
+ * 13       1    coordinateKind   INTEGER_COORDINATES or FLOATING_COORDINATES
+ * 14       2    reserved         0
+ * 16       8    count            The number of points
+ * 24      32    minX, minY,      The bounding box of the points, held as 64 bit
+ *               maxX, maxY       integers or doubles by the coordinate kind. All
+ *                                0 if there are no points.
+ * 56       8    reserved         0
+ * 64            The coordinates, count * 2 * coordinateWidth bytes
+ *
+ * The coordinates start at an offset aligned for any coordinate type, so that
+ * a mapped file can be used as an array of points as it is.
+ */
+static const char POINT_FILE_MAGIC[8] = {'P', 'N', 'T', 'F', 'I', 'L', 'E', '\0'};
+static const uint16_t POINT_FILE_VERSION = 1;
+static const uint16_t POINT_FILE_BYTE_ORDER = 0x0102;
+
+enum CoordinateKind {INTEGER_COORDINATES = 0, FLOATING_COORDINATES = 1};
+
+/** The header of a binary point file, laid out as in the table above */
+struct PointFileHeader
+{
+	/** A bound of the bounding box, by the coordinate kind */
+	union Bound
+	{
+		int64_t integer;
+		double floating;
+	};
+
+	char magic[8];
+	uint16_t version;
+	uint16_t byteOrder;
+	uint8_t coordinateWidth;
+	uint8_t coordinateKind;
+	uint16_t reserved;
+	uint64_t count;
+	Bound minX;
+	Bound minY;
+	Bound maxX;
+	Bound maxY;
+	uint64_t padding;
+};
+
+/**
+ * This class maps a binary point file into memory, checks its header, and
+ * gives the points in it as an array. The mapping is private and writable, so
+ * the points can be sorted and removed in place, as by a set that adopts them,
+ * without changing the file. Only the pages written to are copied. Input that
+ * can't be mapped, such as a pipe, is read whole into a buffer instead. A
+ * problem with the file is reported to the standard error stream.
+ */
+class PointFile
+{
+public:
+
+	/**
+	 * Default Constructor, of an object not mapping any file
+	 */
+	PointFile();
+
+	/**
+	 * Destructor. Unmaps the file, so the points given by the object must not
+	 * be used after it is destroyed.
+	 */
+	~PointFile();
+
+	/**
+	 * Returns true iff the given descriptor is of a regular file starting
+	 * with the magic of a binary point file. The offset of the descriptor is
+	 * not changed.
+	 */
+	static bool isPointFile(const int fd);
+
+	/**
+	 * Maps the binary point file of the given descriptor, from its start, or
+	 * reads it if it can't be mapped. The descriptor is not closed, and may be
+	 * closed once the file is mapped.
+	 * @return True iff the file was mapped or read, and its header is valid
+	 */
+	bool map(const int fd);
+
+	/** Returns the header of the mapped file */
+	const PointFileHeader& header() const;
+
+	/** Returns the number of points in the mapped file */
+	int size() const;
+
+	/**
+	 * Returns true iff the coordinates of the mapped file are of the given
+	 * type
+	 */
+	template <typename Coordinate>
+	bool holds() const;
+
+	/**
+	 * Returns the points of the mapped file, or a nullptr if their
+	 * coordinates aren't of the given type
+	 */
+	template <typename Coordinate>
+	BasicPoint<Coordinate>* points() const;
+
+private:
+
+	void* _mapping; // The mapped file or the buffer read, or nullptr if neither
+	size_t _mappingLength;
+	bool _mapped; // True iff the file is mapped, rather than read into a buffer
+
+	/** Checks the header of the mapped file against its length, and reports
+	 * the first problem found */
+	bool _validate() const;
+
+	/** Reads the whole input of the given descriptor into a buffer. Returns
+	 * true iff it was read and holds at least a header */
+	bool _read(const int fd);
+
+	PointFile(const PointFile&);
+	PointFile& operator=(const PointFile&);
+};
+
+/**
+ * Writes the given n points to the given descriptor as a binary point file,
+ * with the bounding box of the points in its header.
+ * @return True iff the whole file was written
+ */
+template <typename Coordinate>
+bool writePointFile(const int fd, const BasicPoint<Coordinate>* points, const int n);
+
+#endif
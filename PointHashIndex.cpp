@@ -0,0 +1,356 @@
+// PointHashIndex.cpp
+#include "PointHashIndex.h"
+#include "HullStats.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+
+using namespace std;
+
+// --------------------------------------------------------------------------------------
+// This file contains the implementation of the class BasicPointHashIndex.
+// --------------------------------------------------------------------------------------
+
+
+/* The table is only allocated upon the first insertion, so that empty indexes
+ * don't cost an allocation. It then starts with 16 slots, and doubles whenever
+ * it becomes more than half full. */
+static const int TABLE_STARTING_SIZE = 16;
+static const int TABLE_INCREASE_FACTOR = 2;
+static const int MAX_LOAD_DENOMINATOR = 2;
+
+
+/** Allocates a table of the given capacity with all slots empty */
+template <typename Entry>
+static Entry* allocateTable(const int capacity)
+{
+	Entry* table;
+	if((table = (Entry*)malloc(sizeof(Entry) * capacity)) == nullptr)
+	{
+		exit(1);
+	}
+	for(int i = 0; i < capacity; i++)
+	{
+		table[i].position = NO_POSITION;
+	}
+	return table;
+}
+
+
+/**
+ * Default constructor. No table is allocated until the first insertion.
+ */
+template <typename Coordinate>
+BasicPointHashIndex<Coordinate>::BasicPointHashIndex():_size(0), _capacity(0), _table(nullptr){}
+
+
+/**
+ * Copy constructor. The table is copied as is, since the slots of the entries
+ * only depend on the capacity. Copying an empty index allocates nothing.
+ */
+template <typename Coordinate>
+BasicPointHashIndex<Coordinate>::BasicPointHashIndex(const BasicPointHashIndex& other):
+	_size(other._size), _capacity(other._capacity), _table(nullptr)
+{
+	if(_size == 0)
+	{
+		_capacity = 0;
+		return;
+	}
+
+	if((_table = (Entry*)malloc(sizeof(Entry) * _capacity)) == nullptr)
+	{
+		exit(1);
+	}
+	memcpy(_table, other._table, sizeof(Entry) * _capacity);
+}
+
+
+/**
+ * Move Constructor, takes over the table of the given index, leaving it empty
+ */
+template <typename Coordinate>
+BasicPointHashIndex<Coordinate>::BasicPointHashIndex(BasicPointHashIndex&& other):
+	_size(other._size), _capacity(other._capacity), _table(other._table)
+{
+	other._size = 0;
+	other._capacity = 0;
+	other._table = nullptr;
+}
+
+
+/**
+ * Destructor
+ */
+template <typename Coordinate>
+BasicPointHashIndex<Coordinate>::~BasicPointHashIndex()
+{
+	free(_table);
+}
+
+
+/** Returns the slot the probing for the given coordinates starts at. The
+ * coordinates are packed into a single 64 bit key, which is mixed with the
+ * murmur3 finalizer so that nearby points are scattered across the table. */
+template <typename Coordinate>
+int BasicPointHashIndex<Coordinate>::_homeSlot(const Coordinate x, const Coordinate y) const
+{
+	uint64_t key = packCoordinates(x, y);
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ULL;
+	key ^= key >> 33;
+	return (int)(key & (uint64_t)(_capacity - 1));
+}
+
+
+/** Returns the slot holding the given coordinates, or the empty slot at
+ * which the probing for them stopped */
+template <typename Coordinate>
+int BasicPointHashIndex<Coordinate>::_findSlot(const Coordinate x, const Coordinate y) const
+{
+	int slot = _homeSlot(x, y);
+	while(_table[slot].position != NO_POSITION and
+	      (_table[slot].x != x or _table[slot].y != y))
+	{
+		slot = (slot + 1) & (_capacity - 1);
+	}
+	return slot;
+}
+
+
+/**
+ * Returns the position stored for the given coordinates, or NO_POSITION if
+ * the coordinates are not in the index.
+ */
+template <typename Coordinate>
+int BasicPointHashIndex<Coordinate>::find(const Coordinate x, const Coordinate y) const
+{
+	if(_size == 0)
+	{
+		return NO_POSITION;
+	}
+	return _table[_findSlot(x, y)].position;
+}
+
+
+/**
+ * Stores the given position for the given coordinates. Requires the
+ * coordinates not to be in the index already.
+ */
+template <typename Coordinate>
+void BasicPointHashIndex<Coordinate>::insert(const Coordinate x, const Coordinate y, const int position)
+{
+	if((_size + 1) * MAX_LOAD_DENOMINATOR > _capacity)
+	{
+		_rehash(max(TABLE_STARTING_SIZE, _capacity * TABLE_INCREASE_FACTOR));
+	}
+
+	int slot = _findSlot(x, y);
+	assert(_table[slot].position == NO_POSITION);
+	_table[slot].x = x;
+	_table[slot].y = y;
+	_table[slot].position = position;
+	_size++;
+}
+
+
+/**
+ * Stores the given position for the given coordinates, unless they are in the
+ * index already. The slot found by the probe is either the one holding the
+ * coordinates or the empty one they are stored in, so the lookup and the
+ * insertion take a single probe.
+ */
+template <typename Coordinate>
+int BasicPointHashIndex<Coordinate>::insertIfAbsent(const Coordinate x, const Coordinate y, const int position)
+{
+	if((_size + 1) * MAX_LOAD_DENOMINATOR > _capacity)
+	{
+		_rehash(max(TABLE_STARTING_SIZE, _capacity * TABLE_INCREASE_FACTOR));
+	}
+
+	int slot = _findSlot(x, y);
+	if(_table[slot].position != NO_POSITION)
+	{
+		return _table[slot].position;
+	}
+	_table[slot].x = x;
+	_table[slot].y = y;
+	_table[slot].position = position;
+	_size++;
+	return NO_POSITION;
+}
+
+
+/**
+ * Replaces the position stored for the given coordinates. Requires the
+ * coordinates to be in the index.
+ */
+template <typename Coordinate>
+void BasicPointHashIndex<Coordinate>::setPosition(const Coordinate x, const Coordinate y, const int position)
+{
+	int slot = _findSlot(x, y);
+	assert(_table[slot].position != NO_POSITION);
+	_table[slot].position = position;
+}
+
+
+/**
+ * Removes the given coordinates from the index. Instead of leaving a marker in
+ * the freed slot, the following entries of the probe sequence are shifted
+ * back into it whenever that keeps them reachable from their home slot.
+ */
+template <typename Coordinate>
+bool BasicPointHashIndex<Coordinate>::erase(const Coordinate x, const Coordinate y)
+{
+	if(_size == 0)
+	{
+		return false;
+	}
+
+	int hole = _findSlot(x, y);
+	if(_table[hole].position == NO_POSITION)
+	{
+		return false;
+	}
+
+	int mask = _capacity - 1;
+	int slot = hole;
+	while(true)
+	{
+		slot = (slot + 1) & mask;
+		if(_table[slot].position == NO_POSITION)
+		{
+			break;
+		}
+
+		// The entry may fill the hole only if its home slot is not
+		// cyclically located between the hole and the entry itself.
+		int home = _homeSlot(_table[slot].x, _table[slot].y);
+		if(((slot - home) & mask) >= ((slot - hole) & mask))
+		{
+			_table[hole] = _table[slot];
+			hole = slot;
+		}
+	}
+	_table[hole].position = NO_POSITION;
+	_size--;
+	return true;
+}
+
+
+/** Removes all entries from the index, keeping the allocated table. */
+template <typename Coordinate>
+void BasicPointHashIndex<Coordinate>::clear()
+{
+	for(int i = 0; i < _capacity; i++)
+	{
+		_table[i].position = NO_POSITION;
+	}
+	_size = 0;
+}
+
+
+/** Makes sure n entries can be held without growing the table. */
+template <typename Coordinate>
+void BasicPointHashIndex<Coordinate>::reserve(const int n)
+{
+	int capacity = max(TABLE_STARTING_SIZE, _capacity);
+	while(n * MAX_LOAD_DENOMINATOR > capacity)
+	{
+		capacity *= TABLE_INCREASE_FACTOR;
+	}
+	if(n > 0 and capacity != _capacity)
+	{
+		_rehash(capacity);
+	}
+}
+
+
+/** Shrinks the table to the smallest capacity that holds the current
+ * entries, freeing it if the index is empty. */
+template <typename Coordinate>
+void BasicPointHashIndex<Coordinate>::shrinkToFit()
+{
+	if(_size == 0)
+	{
+		free(_table);
+		_table = nullptr;
+		_capacity = 0;
+		return;
+	}
+
+	int capacity = TABLE_STARTING_SIZE;
+	while(_size * MAX_LOAD_DENOMINATOR > capacity)
+	{
+		capacity *= TABLE_INCREASE_FACTOR;
+	}
+	if(capacity < _capacity)
+	{
+		_rehash(capacity);
+	}
+}
+
+
+/** Returns the number of entries in the index */
+template <typename Coordinate>
+int BasicPointHashIndex<Coordinate>::size() const
+{
+	return _size;
+}
+
+
+/** Reallocates the table with the given capacity and reinserts all
+ * entries */
+template <typename Coordinate>
+void BasicPointHashIndex<Coordinate>::_rehash(const int capacity)
+{
+	Entry* oldTable = _table;
+	int oldCapacity = _capacity;
+	HULL_COUNT(INDEX_REHASHES, 1);
+
+	_table = allocateTable<Entry>(capacity);
+	_capacity = capacity;
+	for(int i = 0; i < oldCapacity; i++)
+	{
+		if(oldTable[i].position != NO_POSITION)
+		{
+			_table[_findSlot(oldTable[i].x, oldTable[i].y)] = oldTable[i];
+		}
+	}
+	free(oldTable);
+}
+
+
+/** Swaps between the data of the given indexes. */
+template <typename Coordinate>
+void swapIndexes(BasicPointHashIndex<Coordinate>& a, BasicPointHashIndex<Coordinate>& b)
+{
+	swap(a._size, b._size);
+	swap(a._capacity, b._capacity);
+	swap(a._table, b._table);
+}
+
+
+/**
+ * Destroys current index and reloads it with the entries of the given
+ * index
+ */
+template <typename Coordinate>
+BasicPointHashIndex<Coordinate>& BasicPointHashIndex<Coordinate>::operator=(BasicPointHashIndex other)
+{
+	swapIndexes(*this, other);
+	return *this;
+}
+
+
+template class BasicPointHashIndex<int16_t>;
+template class BasicPointHashIndex<int32_t>;
+template class BasicPointHashIndex<int64_t>;
+template class BasicPointHashIndex<double>;
+template void swapIndexes(BasicPointHashIndex<int16_t>& a, BasicPointHashIndex<int16_t>& b);
+template void swapIndexes(BasicPointHashIndex<int32_t>& a, BasicPointHashIndex<int32_t>& b);
+template void swapIndexes(BasicPointHashIndex<int64_t>& a, BasicPointHashIndex<int64_t>& b);
+template void swapIndexes(BasicPointHashIndex<double>& a, BasicPointHashIndex<double>& b);
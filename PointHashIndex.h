@@ -0,0 +1,134 @@
+// PointHashIndex.h
+#ifndef POINT_HASH_INDEX_H
+#define POINT_HASH_INDEX_H
+
+#include <cstdint>
+#include "Point.h"
+
+static const int NO_POSITION = -1;
+
+template <typename Coordinate>
+class BasicPointHashIndex;
+
+/** Swaps between the data of the given indexes. */
+template <typename Coordinate>
+void swapIndexes(BasicPointHashIndex<Coordinate>& a, BasicPointHashIndex<Coordinate>& b);
+
+/**
+ * This class maps the coordinates of a point to the position of that point
+ * within an array. It is implemented as an open addressing hash table, keyed
+ * on the packed (x,y) pair, with linear probing. The table is kept at most half
+ * full, so that lookups, insertions and erasures are O(1) expected.
+ */
+template <typename Coordinate>
+class BasicPointHashIndex
+{
+public:
+
+	/** Swaps between the data of the given indexes. */
+	friend void swapIndexes<>(BasicPointHashIndex& a, BasicPointHashIndex& b);
+
+	/**
+	 * Default Constructor
+	 */
+	BasicPointHashIndex();
+
+	/**
+	 * Copy Constructor, creates an index with the same entries as the given
+	 * index
+	 */
+	BasicPointHashIndex(const BasicPointHashIndex& other);
+
+	/**
+	 * Move Constructor, takes over the table of the given index, leaving it
+	 * empty
+	 */
+	BasicPointHashIndex(BasicPointHashIndex&& other);
+
+	/**
+	 * Destructor
+	 */
+	~BasicPointHashIndex();
+
+	/**
+	 * Destroys current index and reloads it with the entries of the given
+	 * index
+	 */
+	BasicPointHashIndex& operator=(BasicPointHashIndex other);
+
+	/**
+	 * Returns the position stored for the given coordinates, or NO_POSITION if
+	 * the coordinates are not in the index.
+	 */
+	int find(const Coordinate x, const Coordinate y) const;
+
+	/**
+	 * Stores the given position for the given coordinates. Requires the
+	 * coordinates not to be in the index already.
+	 */
+	void insert(const Coordinate x, const Coordinate y, const int position);
+
+	/**
+	 * Stores the given position for the given coordinates, unless they are in
+	 * the index already. Both are done with a single probe.
+	 * @return The position already stored for the coordinates, or NO_POSITION
+	 * if the given position was stored
+	 */
+	int insertIfAbsent(const Coordinate x, const Coordinate y, const int position);
+
+	/**
+	 * Replaces the position stored for the given coordinates. Requires the
+	 * coordinates to be in the index.
+	 */
+	void setPosition(const Coordinate x, const Coordinate y, const int position);
+
+	/**
+	 * Removes the given coordinates from the index.
+	 * @return True iff the coordinates were in the index
+	 */
+	bool erase(const Coordinate x, const Coordinate y);
+
+	/** Removes all entries from the index, keeping the allocated table. */
+	void clear();
+
+	/** Makes sure n entries can be held without growing the table. */
+	void reserve(const int n);
+
+	/** Shrinks the table to the smallest capacity that holds the current
+	 * entries, freeing it if the index is empty. */
+	void shrinkToFit();
+
+	/** Returns the number of entries in the index */
+	int size() const;
+
+private:
+
+	/** A single slot in the table. A slot is empty iff its position is
+	 * NO_POSITION */
+	struct Entry
+	{
+		Coordinate x;
+		Coordinate y;
+		int position;
+	};
+
+	int _size;
+	int _capacity; // Always a power of two
+	Entry* _table;
+
+	/** Returns the slot the probing for the given coordinates starts at */
+	int _homeSlot(const Coordinate x, const Coordinate y) const;
+
+	/** Returns the slot holding the given coordinates, or the empty slot at
+	 * which the probing for them stopped */
+	int _findSlot(const Coordinate x, const Coordinate y) const;
+
+	/** Reallocates the table with the given capacity and reinserts all
+	 * entries */
+	void _rehash(const int capacity);
+};
+
+/** The index of the points used by the hull algorithms */
+typedef BasicPointHashIndex<int32_t> PointHashIndex;
+
+#endif
@@ -0,0 +1,388 @@
+// PointReader.cpp
+#include "PointReader.h"
+#include "HullStats.h"
+#include <iostream>
+#include <string>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+// --------------------------------------------------------------------------------------
+// This file contains the implementation of the class PointReader.
+// --------------------------------------------------------------------------------------
+
+
+/* Input that can't be memory mapped is read in blocks of 1MB. The buffer is
+ * only grown beyond that if a single line doesn't fit in it. */
+static const size_t READ_BLOCK_SIZE = 1 << 20;
+static const int BUFFER_INCREASE_FACTOR = 2;
+
+/** The possible results of parsing a single line */
+enum LineType
+{
+	POINT_LINE,
+	BLANK_LINE,
+	MALFORMED_LINE
+};
+
+
+/** Returns the first position from the given one that isn't a blank */
+static inline const char* skipBlanks(const char* position, const char* end)
+{
+	while(position < end and (*position == ' ' or *position == '\t' or *position == '\r'))
+	{
+		position++;
+	}
+	return position;
+}
+
+
+/**
+ * Parses a decimal integer with an optional sign, starting at the given
+ * position. On success the position is advanced past the integer.
+ * @return True iff an integer in the range of int was parsed
+ */
+static inline bool parseInteger(const char*& position, const char* end, int& value)
+{
+	const char* current = position;
+	bool negative = false;
+	if(current < end and (*current == '-' or *current == '+'))
+	{
+		negative = (*current == '-');
+		current++;
+	}
+
+	const char* digitsStart = current;
+	long long result = 0;
+	while(current < end and (unsigned)(*current - '0') < 10)
+	{
+		result = result * 10 + (*current - '0');
+		if(result > (long long)INT_MAX + 1)
+		{
+			return false;
+		}
+		current++;
+	}
+
+	if(current == digitsStart or (!negative and result > INT_MAX))
+	{
+		return false;
+	}
+	value = (int)(negative ? -result : result);
+	position = current;
+	return true;
+}
+
+
+/** Parses a single line, not including its line break, in the format
+ * "<x>,<y>". Blanks are allowed around both coordinates. */
+static LineType parseLine(const char* line, const char* lineEnd, int& x, int& y)
+{
+	const char* position = skipBlanks(line, lineEnd);
+	if(position == lineEnd)
+	{
+		return BLANK_LINE;
+	}
+
+	if(!parseInteger(position, lineEnd, x))
+	{
+		return MALFORMED_LINE;
+	}
+	position = skipBlanks(position, lineEnd);
+	if(position == lineEnd or *position != ',')
+	{
+		return MALFORMED_LINE;
+	}
+	position = skipBlanks(position + 1, lineEnd);
+	if(!parseInteger(position, lineEnd, y))
+	{
+		return MALFORMED_LINE;
+	}
+	return (skipBlanks(position, lineEnd) == lineEnd) ? POINT_LINE : MALFORMED_LINE;
+}
+
+
+/**
+ * Constructs a reader of the given file descriptor. The input is memory mapped
+ * if possible, and otherwise a buffer is allocated for reading it in blocks.
+ */
+PointReader::PointReader(const int fd):_position(nullptr), _end(nullptr), _mapping(nullptr),
+                                       _mappingLength(0), _fd(fd), _buffer(nullptr),
+                                       _bufferSize(0), _endOfInput(false), _lineNumber(0),
+                                       _errors(0), _delimited(false), _atDelimiter(false)
+{
+	if(_map())
+	{
+		return;
+	}
+
+	_bufferSize = READ_BLOCK_SIZE;
+	if((_buffer = (char*)malloc(_bufferSize)) == nullptr)
+	{
+		exit(1);
+	}
+	_position = _buffer;
+	_end = _buffer;
+}
+
+
+/**
+ * Destructor
+ */
+PointReader::~PointReader()
+{
+	if(_mapping != nullptr)
+	{
+		munmap(_mapping, _mappingLength);
+	}
+	free(_buffer);
+}
+
+
+/** Tries to memory map the whole input, from the current offset of the
+ * descriptor. Only non empty regular files can be mapped. */
+bool PointReader::_map()
+{
+	struct stat status;
+	if(fstat(_fd, &status) != 0 or !S_ISREG(status.st_mode))
+	{
+		return false;
+	}
+
+	off_t offset = lseek(_fd, 0, SEEK_CUR);
+	if(offset < 0 or offset >= status.st_size)
+	{
+		return false;
+	}
+
+	_mappingLength = status.st_size;
+	_mapping = mmap(nullptr, _mappingLength, PROT_READ, MAP_PRIVATE, _fd, 0);
+	if(_mapping == MAP_FAILED)
+	{
+		_mapping = nullptr;
+		return false;
+	}
+	madvise(_mapping, _mappingLength, MADV_SEQUENTIAL);
+
+	_position = (const char*)_mapping + offset;
+	_end = (const char*)_mapping + _mappingLength;
+	_endOfInput = true;
+	HULL_COUNT(BYTES_READ, _end - _position);
+	return true;
+}
+
+
+/** Moves the unparsed data to the start of the buffer and reads the next
+ * block after it. The buffer is grown if the unparsed data fills it. */
+bool PointReader::_refill()
+{
+	if(_endOfInput)
+	{
+		return false;
+	}
+
+	size_t remaining = _end - _position;
+	memmove(_buffer, _position, remaining);
+	if(remaining == _bufferSize)
+	{
+		_bufferSize *= BUFFER_INCREASE_FACTOR;
+		if((_buffer = (char*)realloc(_buffer, _bufferSize)) == nullptr)
+		{
+			exit(1);
+		}
+	}
+	_position = _buffer;
+	_end = _buffer + remaining;
+
+	ssize_t bytesRead;
+	do
+	{
+		bytesRead = read(_fd, _buffer + remaining, _bufferSize - remaining);
+	} while(bytesRead < 0 and errno == EINTR);
+
+	if(bytesRead <= 0)
+	{
+		_endOfInput = true;
+		return false;
+	}
+	_end += bytesRead;
+	HULL_COUNT(BYTES_READ, bytesRead);
+	return true;
+}
+
+
+/**
+ * Finds the next line of the input, not including its line break, and moves
+ * past it. The line lies in the mapping or the buffer, and stays valid until
+ * the next line is read.
+ */
+bool PointReader::_nextLine(const char*& line, const char*& lineEnd)
+{
+	while(true)
+	{
+		lineEnd = (const char*)memchr(_position, '\n', _end - _position);
+		if(lineEnd == nullptr)
+		{
+			if(_refill())
+			{
+				continue;
+			}
+			if(_position == _end)
+			{
+				return false;
+			}
+			// The last line of the input has no line break
+			lineEnd = _end;
+		}
+
+		line = _position;
+		_position = (lineEnd == _end) ? _end : lineEnd + 1;
+		_lineNumber++;
+		return true;
+	}
+}
+
+
+/** Moves back to the start of the given line, the last one read */
+void PointReader::_unreadLine(const char* line)
+{
+	_position = line;
+	_lineNumber--;
+}
+
+
+/**
+ * Reads the next point in the input into the given coordinates. Lines are
+ * parsed in place, where they lie in the mapping or the buffer.
+ */
+bool PointReader::next(int& x, int& y)
+{
+	const char* line;
+	const char* lineEnd;
+	while(!_atDelimiter and _nextLine(line, lineEnd))
+	{
+		if(_delimited and _isDelimiter(line, lineEnd))
+		{
+			_atDelimiter = true;
+			return false;
+		}
+
+		LineType type = parseLine(line, lineEnd, x, y);
+		if(type == POINT_LINE)
+		{
+			return true;
+		}
+		if(type == MALFORMED_LINE)
+		{
+			_reportError(line, lineEnd, "point");
+		}
+	}
+	return false;
+}
+
+
+/** Sets the line that separates datasets in the input */
+void PointReader::setDelimiter(const string& delimiter)
+{
+	_delimiter = delimiter;
+	_delimited = true;
+}
+
+
+/** Checks if the given line is the delimiter, blanks around it aside */
+bool PointReader::_isDelimiter(const char* line, const char* lineEnd) const
+{
+	const char* start = skipBlanks(line, lineEnd);
+	while(lineEnd > start and (lineEnd[-1] == ' ' or lineEnd[-1] == '\t' or lineEnd[-1] == '\r'))
+	{
+		lineEnd--;
+	}
+	return (size_t)(lineEnd - start) == _delimiter.size() and
+	       memcmp(start, _delimiter.data(), _delimiter.size()) == 0;
+}
+
+
+/**
+ * Moves on to the next dataset of the input. Blank lines are skipped, so that
+ * the input doesn't end with an empty dataset after its last delimiter.
+ */
+bool PointReader::nextDataset()
+{
+	_atDelimiter = false;
+	const char* line;
+	const char* lineEnd;
+	while(_nextLine(line, lineEnd))
+	{
+		if(skipBlanks(line, lineEnd) != lineEnd)
+		{
+			_unreadLine(line);
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * Reads the next non blank line as a count of points. A line that isn't a
+ * valid count is reported, since the datasets after it can't be told apart.
+ */
+bool PointReader::nextCount(int& count)
+{
+	const char* line;
+	const char* lineEnd;
+	while(_nextLine(line, lineEnd))
+	{
+		const char* position = skipBlanks(line, lineEnd);
+		if(position == lineEnd)
+		{
+			continue;
+		}
+		if(parseInteger(position, lineEnd, count) and count >= 0 and
+		   skipBlanks(position, lineEnd) == lineEnd)
+		{
+			return true;
+		}
+		_reportError(line, lineEnd, "count");
+		return false;
+	}
+	return false;
+}
+
+
+/** Reports the given line as malformed, not being a valid value of the given
+ * kind */
+void PointReader::_reportError(const char* line, const char* lineEnd, const char* expected)
+{
+	_errors++;
+	cerr << "Line " << _lineNumber << " is not a valid " << expected << ": \""
+	     << string(line, lineEnd) << "\"" << endl;
+}
+
+
+/** Returns true iff the unread input starts with the given bytes, reading
+ * blocks into the buffer until enough of the input is held */
+bool PointReader::startsWith(const char* prefix, const size_t length)
+{
+	while((size_t)(_end - _position) < length)
+	{
+		if(!_refill())
+		{
+			return false;
+		}
+	}
+	return memcmp(_position, prefix, length) == 0;
+}
+
+
+/** Returns the number of malformed lines found so far */
+int PointReader::errorCount() const
+{
+	return _errors;
+}
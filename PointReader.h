@@ -0,0 +1,122 @@
+// PointReader.h
+#ifndef POINT_READER_H
+#define POINT_READER_H
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+/**
+ * This class reads points from a file descriptor, one point per line in the
+ * format "<x>,<y>". Regular files are memory mapped and parsed in place; any
+ * other input (pipes, terminals) is read in large blocks into an internal
+ * buffer. The coordinates are parsed with a hand rolled integer scanner, with
+ * no intermediate strings or streams.
+ * Blank lines are ignored. Any other line that isn't a valid point is reported
+ * to the standard error stream with its line number, and skipped.
+ * An input may hold many datasets, either separated by delimiter lines, or
+ * each preceded by a line holding its count of points.
+ */
+class PointReader
+{
+public:
+
+	/**
+	 * Constructs a reader of the given file descriptor. The descriptor is not
+	 * closed by the reader.
+	 */
+	PointReader(const int fd);
+
+	/**
+	 * Destructor
+	 */
+	~PointReader();
+
+	/**
+	 * Reads the next point in the input into the given coordinates.
+	 * @return True iff a point was read, false if the input has ended
+	 */
+	bool next(int& x, int& y);
+
+	/**
+	 * Sets the line that separates datasets in the input. Once set, next()
+	 * returns false at a delimiter line as at the end of the input, until
+	 * nextDataset() is called.
+	 */
+	void setDelimiter(const string& delimiter);
+
+	/**
+	 * Moves on to the next dataset in the input, past the delimiter line at
+	 * which next() stopped, if any. Called before reading every dataset,
+	 * including the first.
+	 * @return True iff there is another dataset, false if only blank lines
+	 * remain in the input
+	 */
+	bool nextDataset();
+
+	/**
+	 * Reads the next non blank line as a count of points, for inputs in which
+	 * every dataset is preceded by its count. The dataset then consists of the
+	 * next count valid points.
+	 * @return True iff a count was read, false if the input has ended or the
+	 * line isn't a valid count, which is reported
+	 */
+	bool nextCount(int& count);
+
+	/**
+	 * Returns true iff the unread input starts with the given bytes. The
+	 * input is read as far as needed but nothing is consumed, so the format
+	 * of an input that can't be rewound, such as a pipe, can be told.
+	 */
+	bool startsWith(const char* prefix, const size_t length);
+
+	/** Returns the number of malformed lines found so far */
+	int errorCount() const;
+
+private:
+
+	const char* _position; // The start of the next line to be parsed
+	const char* _end; // The end of the data currently available
+
+	void* _mapping; // The memory mapped file, or nullptr if reading blocks
+	size_t _mappingLength;
+
+	int _fd;
+	char* _buffer;
+	size_t _bufferSize;
+	bool _endOfInput; // True once the descriptor has no more data to read
+
+	long _lineNumber;
+	int _errors;
+
+	string _delimiter;
+	bool _delimited; // True iff a delimiter was set
+	bool _atDelimiter; // True iff next() stopped at a delimiter line
+
+	/** Tries to memory map the whole input. Returns true iff successful */
+	bool _map();
+
+	/** Moves the unparsed data to the start of the buffer and reads the next
+	 * block after it. Returns false iff no more data was read. */
+	bool _refill();
+
+	/** Finds the next line of the input and moves past it. Returns false
+	 * iff the input has ended */
+	bool _nextLine(const char*& line, const char*& lineEnd);
+
+	/** Moves back to the start of the given line, the last one read */
+	void _unreadLine(const char* line);
+
+	/** Checks if the given line is the delimiter */
+	bool _isDelimiter(const char* line, const char* lineEnd) const;
+
+	/** Reports the given line as malformed, not being a valid value of the
+	 * given kind */
+	void _reportError(const char* line, const char* lineEnd, const char* expected);
+
+	PointReader(const PointReader&);
+	PointReader& operator=(const PointReader&);
+};
+
+#endif
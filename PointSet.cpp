@@ -1,10 +1,14 @@
 // PointSet.cpp
 #include <typeinfo>
 #include "PointSet.h"
+#include "HullStats.h"
 #include <string>
 #include <algorithm>
+#include <functional>
 #include <cstdlib> /* Using c-style memory allocation in order to control the
 			    	  allocation and resizing of the array.*/
+#include <cstring>
+#include <cstdint>
 #include <cassert> /* Using c-style assertion, as static assertion is not what
 					  is needed in this case. I'm looking for runtime error
 					  checking. */
@@ -15,22 +19,115 @@ using namespace std;
 // --------------------------------------------------------------------------------------
 
 
-/* PointerSet is implemented as a vector: an array of pointers to Point objects
- * that doubles in size whenever the size of the array is maxed. The array size
- * starts at 10, fairly arbitrarily. 
+/* PointerSet is implemented as a vector: a contiguous array of Point objects,
+ * stored by value, that doubles in size whenever the size of the array is
+ * maxed. The array is only allocated when the first point is added, so that
+ * empty sets (e.g. temporaries) don't cost an allocation. Its size then starts
+ * at 10, fairly arbitrarily. 
  */
 static const int ARRAY_STARTING_SIZE = 10;
 static const int ARRAY_INCREASE_FACTOR = 2;
 
+/* When the array is full in the LAZY_REMOVAL mode, it is compacted instead of
+ * grown if at least a quarter of its places are taken by removed points, so
+ * that the compactions take amortized O(1) time per added point. */
+static const size_t COMPACTION_DENOMINATOR = 4;
+
 /**
  * Constructs the with the given values
  */
-PointSet::PointSet(const int setSize, const int arraySize):_setSize(setSize), _arraySize(arraySize) 
+template <typename Coordinate>
+BasicPointSet<Coordinate>::BasicPointSet(const int setSize, const int arraySize):
+                           _setSize(setSize), _arraySize(arraySize),
+                           _array(nullptr), _ownsArray(true), _fingerprintSum(0),
+                           _fingerprintXor(0),
+                           _removalMode(ORDERED_REMOVAL)
+{
+	_allocateArray();
+}
+
+
+/**
+ * Default constructor
+ */
+template <typename Coordinate>
+BasicPointSet<Coordinate>::BasicPointSet():BasicPointSet(0, 0){}
+
+/**
+ * Copy constructor. Since the points are stored by value, the whole array is
+ * copied at once, and so is the table of the hash index. The new array is
+ * sized to fit the points exactly, so copying a set takes one allocation for
+ * the array and one for the index, and none when the set is empty. The given
+ * set is compacted first, before its size is taken.
+ */
+template <typename Coordinate>
+BasicPointSet<Coordinate>::BasicPointSet(const BasicPointSet& other):
+                           _setSize(other._compacted()._setSize),
+                           _arraySize(other._setSize),
+                           _array(nullptr), _ownsArray(true), _index(other._index),
+                           _fingerprintSum(other._fingerprintSum),
+                           _fingerprintXor(other._fingerprintXor),
+                           _removalMode(other._removalMode)
+{
+	_allocateArray();
+	if(_setSize > 0)
+	{
+		memcpy(_array, other._array, sizeof(BasicPoint<Coordinate>) * _setSize);
+	}
+}
+
+
+/**
+ * Constructs a set from a buffer of n points given as pairs of coordinates.
+ * The array and the hash index are sized for all n points at once, and every
+ * point is looked up and inserted with a single probe of the index.
+ */
+template <typename Coordinate>
+BasicPointSet<Coordinate>::BasicPointSet(const Coordinate* coordinates, const int n):BasicPointSet()
+{
+	_growFor(n);
+	for(int i = 0; i < n; i++)
+	{
+		_appendIfAbsent(BasicPoint<Coordinate>(coordinates[2 * i], coordinates[2 * i + 1]));
+	}
+}
+
+
+/**
+ * Move constructor. The array and the hash index of the given set are taken
+ * over as they are, so nothing is allocated or copied. The given set is left
+ * empty, and its observers are notified.
+ */
+template <typename Coordinate>
+BasicPointSet<Coordinate>::BasicPointSet(BasicPointSet&& other):
+                           _setSize(other._setSize), _arraySize(other._arraySize),
+                           _array(other._array), _ownsArray(other._ownsArray),
+                           _index(move(other._index)),
+                           _fingerprintSum(other._fingerprintSum),
+                           _fingerprintXor(other._fingerprintXor),
+                           _removalMode(other._removalMode),
+                           _removedPlaces(move(other._removedPlaces))
+{
+	other._setSize = 0;
+	other._arraySize = 0;
+	other._array = nullptr;
+	other._ownsArray = true;
+	other._removedPlaces.clear();
+	other._fingerprintSum = 0;
+	other._fingerprintXor = 0;
+	other._notifyReset();
+}
+
+
+/** Allocates the array according to the array size, if it is positive */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::_allocateArray()
 {
 	/* Using the c-style malloc in order to allocate an array to hold the Point
 	 * objects, without initializing any such object yet. The c-style is also
 	 * used in order to efficiently resize the array later on. */
-	if((_array = (const Point**)malloc(sizeof(Point*) * _arraySize)) == nullptr)
+	if(_arraySize > 0 and
+	   (_array = (BasicPoint<Coordinate>*)malloc(sizeof(BasicPoint<Coordinate>) * _arraySize)) == nullptr)
 	{
 		exit(1);
 	}
@@ -38,164 +135,819 @@ PointSet::PointSet(const int setSize, const int arraySize):_setSize(setSize), _a
 
 
 /**
- * Default constructor
+ * Destructor
  */
-PointSet::PointSet():PointSet(0, ARRAY_STARTING_SIZE){}
+template <typename Coordinate>
+BasicPointSet<Coordinate>::~BasicPointSet()
+{
+	if(_ownsArray)
+	{
+		free(_array);
+	}
+}
+
+
+/** Resizes the array to hold the given number of points, keeping the points in
+ * the places in use. An array borrowed by adopt is never resized or freed:
+ * the points are copied out of it into a new array of the set's own. */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::_resizeArray(const int size)
+{
+	BasicPoint<Coordinate>* borrowed = nullptr;
+	if(!_ownsArray)
+	{
+		borrowed = _array;
+		_array = nullptr;
+		_ownsArray = true;
+	}
+
+	if(size == 0)
+	{
+		free(_array);
+		_array = nullptr;
+	}
+	else if((_array = (BasicPoint<Coordinate>*)realloc(_array,
+	                                                   size * sizeof(BasicPoint<Coordinate>))) == nullptr)
+	{
+		exit(1);
+	}
+
+	if(borrowed != nullptr and size > 0)
+	{
+		memcpy(_array, borrowed, sizeof(BasicPoint<Coordinate>) * min(_usedPlaces(), size));
+	}
+	_arraySize = size;
+	HULL_COUNT(ARRAY_REALLOCATIONS, 1);
+}
+
+
+/** Makes sure n points can be held without growing the array or the hash
+ * index, so that adding n points takes no further allocations */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::reserve(const int n)
+{
+	if(n > _arraySize)
+	{
+		_resizeArray(n);
+	}
+	_index.reserve(n);
+}
+
+
+/** Shrinks the array and the hash index to the smallest sizes that hold the
+ * current points. An empty set frees both. */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::shrinkToFit()
+{
+	_compact();
+	if(_setSize < _arraySize)
+	{
+		_resizeArray(_setSize);
+	}
+	_index.shrinkToFit();
+}
+
+
+/** Returns the number of points the set can hold before its array has to
+ * grow */
+template <typename Coordinate>
+int BasicPointSet<Coordinate>::capacity() const
+{
+	return _arraySize;
+}
+
+
+/** Adds the given point to the end of the set. Requires the point not to be
+ * in the set, and the set to have room for it, so neither is checked. */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::_append(const BasicPoint<Coordinate>& point)
+{
+	_array[_setSize] = point;
+	_index.insert(point.getX(), point.getY(), _setSize);
+	_setSize++;
+	_addToFingerprint(point);
+	for(size_t i = 0; i < _observers.size(); i++)
+	{
+		_observers[i] -> pointAdded(point);
+	}
+}
+
+
+/** Adds the given point to the end of the set iff it isn't in the set. The
+ * index is probed once for both the lookup and the insertion. The observers
+ * are not notified. */
+template <typename Coordinate>
+bool BasicPointSet<Coordinate>::_appendIfAbsent(const BasicPoint<Coordinate>& point)
+{
+	if(_index.insertIfAbsent(point.getX(), point.getY(), _setSize) != NO_POSITION)
+	{
+		return false;
+	}
+	_array[_setSize] = point;
+	_setSize++;
+	_addToFingerprint(point);
+	return true;
+}
+
+
+/** Makes room for n more points in the array and the hash index. The array
+ * grows at most once, to at least double its size, so that adding ranges one
+ * after the other still takes amortized constant time per point. */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::_growFor(const int n)
+{
+	if(_setSize + n > _arraySize)
+	{
+		reserve(max(_setSize + n, _arraySize * ARRAY_INCREASE_FACTOR));
+	}
+	else
+	{
+		_index.reserve(_setSize + n);
+	}
+}
+
 
 /**
- * Copy constructor
+ * Adds the points in the range [begin, end) that aren't in the set, in order.
+ * Room for the whole range is made up front, the points are then appended
+ * with a single probe of the index each, and the observers are notified of
+ * the added points at the end. A range within the array of the set is copied
+ * first, since the compaction and the growth of the array move its points.
  */
-PointSet::PointSet(const PointSet& other):PointSet(other._setSize, other._arraySize)
+template <typename Coordinate>
+int BasicPointSet<Coordinate>::addRange(const BasicPoint<Coordinate>* begin,
+                                        const BasicPoint<Coordinate>* end)
 {
-	for(int i = 0; i < _setSize; i++)
+	less<const BasicPoint<Coordinate>*> before;
+	if(begin != end and !before(begin, _array) and before(begin, _array + _arraySize))
+	{
+		vector<BasicPoint<Coordinate>> copy(begin, end);
+		return addRange(copy.data(), copy.data() + copy.size());
+	}
+
+	_compact();
+	int first = _setSize;
+	_growFor((int)(end - begin));
+	for(const BasicPoint<Coordinate>* point = begin; point != end; point++)
+	{
+		_appendIfAbsent(*point);
+	}
+
+	for(size_t j = 0; j < _observers.size(); j++)
 	{
-		_array[i] = new Point(*other._array[i]);
+		for(int i = first; i < _setSize; i++)
+		{
+			_observers[j] -> pointAdded(_array[i]);
+		}
 	}
+	return _setSize - first;
 }
 
 
 /**
- * Destructor
+ * Replaces the points of the set with the points in the range [begin, end).
+ * The array and the table of the index are kept and reused, and the observers
+ * are notified of a reset once all the points are in.
  */
-PointSet::~PointSet()
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::assign(const BasicPoint<Coordinate>* begin,
+                                       const BasicPoint<Coordinate>* end)
 {
-	for(int i = 0; i < _setSize; i++)
+	_clearPoints();
+	_growFor((int)(end - begin));
+	for(const BasicPoint<Coordinate>* point = begin; point != end; point++)
 	{
-		delete(_array[i]);
+		_appendIfAbsent(*point);
 	}
-	free(_array);
+	_notifyReset();
 }
 
 
-/** Returns the index of given point within the array. Returns -1 if no
- * Point is found. */
-int PointSet::getIndex(const Point& point) const
+/**
+ * Replaces the points of the set with the points of the given array, holding
+ * them in place. Every point is looked up and inserted with a single probe of
+ * the index, and is only written if a repeated point before it was dropped,
+ * so that the pages of a mapped file aren't written to for nothing.
+ */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::adopt(BasicPoint<Coordinate>* points, const int n)
 {
-	for(int i = 0; i < _setSize; i++)
+	if(_ownsArray)
 	{
-		if(_array[i] -> getX() == point.getX() and _array[i] -> getY() == point.getY())
+		free(_array);
+	}
+	_array = points;
+	_arraySize = n;
+	_ownsArray = false;
+	_setSize = 0;
+	_removedPlaces.clear();
+	_index.clear();
+	_index.reserve(n);
+	_fingerprintSum = 0;
+	_fingerprintXor = 0;
+	for(int i = 0; i < n; i++)
+	{
+		if(_index.insertIfAbsent(points[i].getX(), points[i].getY(), _setSize) == NO_POSITION)
 		{
-			return i;
+			if(i != _setSize)
+			{
+				_array[_setSize] = points[i];
+			}
+			_addToFingerprint(points[i]);
+			_setSize++;
 		}
 	}
-	return POINT_NOT_FOUND;
+	_notifyReset();
+}
+
+
+/** Returns a 64 bit hash of the given point, by the splitmix64 finalizer
+ * over its packed coordinates. Unlike the hash of the index, it has to be
+ * strong over all bits, as it is summed and xored over the whole set. */
+template <typename Coordinate>
+static inline unsigned long long fingerprintHash(const BasicPoint<Coordinate>& point)
+{
+	unsigned long long hash = packCoordinates(point.getX(), point.getY());
+	hash += 0x9e3779b97f4a7c15ULL;
+	hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+	return hash ^ (hash >> 31);
+}
+
+
+/** Adds the given point to the fingerprint of the set */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::_addToFingerprint(const BasicPoint<Coordinate>& point)
+{
+	unsigned long long hash = fingerprintHash(point);
+	_fingerprintSum += hash;
+	_fingerprintXor ^= hash;
+}
+
+
+/** Removes the given point from the fingerprint of the set */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::_removeFromFingerprint(const BasicPoint<Coordinate>& point)
+{
+	unsigned long long hash = fingerprintHash(point);
+	_fingerprintSum -= hash;
+	_fingerprintXor ^= hash;
+}
+
+
+/** Returns the index of given point within the array. Returns -1 if no
+ * Point is found. The index is looked up in the hash index, so this takes O(1)
+ * expected time. */
+template <typename Coordinate>
+int BasicPointSet<Coordinate>::getIndex(const BasicPoint<Coordinate>& point) const
+{
+	_compact();
+	int index = _index.find(point.getX(), point.getY());
+	return (index == NO_POSITION) ? POINT_NOT_FOUND : index;
+}
+
+
+/** Empties the hash index and reinserts every point with its current
+ * index in the array */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::_rebuildIndex()
+{
+	_index.clear();
+	_index.reserve(_setSize);
+	for(int i = 0; i < _setSize; i++)
+	{
+		_index.insert(_array[i].getX(), _array[i].getY(), i);
+	}
 }
 
 
-/** Adds point to the end of the array. The add function creates a new Point
- * object, and stores its pointer in the array. The destructor frees the memory
- * of this new object. The memory management of the given point is up to the
- * caller. The size of the array is doubled if the
- * current capacity has been maximized.
+/** Adds point to the end of the array. The add function copies the given point
+ * into the array, so the memory management of the given point is up to the
+ * caller. The size of the array is doubled if the current capacity has been
+ * maximized.
  */
-bool PointSet::add(const Point& point)
+template <typename Coordinate>
+bool BasicPointSet<Coordinate>::add(const BasicPoint<Coordinate>& point)
 {
-	if(getIndex(point) != POINT_NOT_FOUND)
+	if(_index.find(point.getX(), point.getY()) != NO_POSITION)
 	{
 		return false;
 	}
 
-	if(_arraySize == _setSize)
+	if(_arraySize == _usedPlaces())
 	{
-		_arraySize *= ARRAY_INCREASE_FACTOR; 
-		if((_array = (const Point**)realloc(_array, _arraySize * sizeof(Point*))) == nullptr)
+		// Compacting instead of growing only if enough places are freed by it
+		if(!_removedPlaces.empty() and
+		   _removedPlaces.size() * COMPACTION_DENOMINATOR >= (size_t)_arraySize)
 		{
-			exit(1);
+			_compact();
+		}
+		else
+		{
+			_resizeArray((_arraySize == 0) ? ARRAY_STARTING_SIZE : _arraySize * ARRAY_INCREASE_FACTOR);
 		}
 	}
 
-	_array[_setSize] = new Point(point); 
+	int place = _usedPlaces();
+	_array[place] = point;
+	_index.insert(point.getX(), point.getY(), place);
 	_setSize++;
+	_addToFingerprint(point);
+	for(size_t i = 0; i < _observers.size(); i++)
+	{
+		_observers[i] -> pointAdded(point);
+	}
 	return true;
 }
 
 /**
- * Prints the coordinates of all the points in the set 
+ * Prints the coordinates of all the points in the set, one point per line.
+ * The points are formatted straight into the string, without a string or a
+ * stream of their own.
  */
-string PointSet::toString() const
+template <typename Coordinate>
+string BasicPointSet<Coordinate>::toString() const
 {
-	string result = "";
+	_compact();
+	if(_setSize == 0)
+	{
+		return "";
+	}
+
+	/* The string is sized once for the longest text the points may take, and
+	 * cut down to the text written */
+	const int lineLength = BasicPoint<Coordinate>::MAX_TEXT_LENGTH + 1;
+	string result((size_t)_setSize * lineLength, '\0');
+	char* const start = &result[0];
+	char* end = start;
 	for(int i = 0; i < _setSize; i++)
 	{
-		result += _array[i] -> toString() + "\n";
+		end = _array[i].format(end);
+		*end++ = '\n';
 	}
+	result.resize(end - start);
 	return result;
 }
 
 
-/** Removes the given point by moving all following points within the array one
- * cell back. The cell that had the last point receives a nullptr instead */
-bool PointSet::remove(const Point& point)
+/** Removes the given point according to the removal mode of the set. In the
+ * ORDERED_REMOVAL mode all following points are moved within the array one
+ * cell back, and the hash index is updated with the new index of every moved
+ * point. In the UNORDERED_REMOVAL mode only the last point is moved, into the
+ * cell of the removed point. In the LAZY_REMOVAL mode no point is moved, and
+ * the cell of the removed point is kept until the next compaction. */
+template <typename Coordinate>
+bool BasicPointSet<Coordinate>::remove(const BasicPoint<Coordinate>& point)
 {
-	int pointIndex = getIndex(point);
-	if(pointIndex == POINT_NOT_FOUND)
+	int pointIndex = _index.find(point.getX(), point.getY());
+	if(pointIndex == NO_POSITION)
 	{
 		return false;
 	}
 
-	delete(_array[pointIndex]);
-
-	int i;
-	for(i = pointIndex + 1; i < _setSize; i++)
+	const BasicPoint<Coordinate> removed = point; // The given point may be the one moved over
+	_index.erase(point.getX(), point.getY());
+	if(_removalMode == LAZY_REMOVAL)
 	{
-		_array[i-1] = _array[i];
+		_removedPlaces.push_back(pointIndex);
+	}
+	else if(_removalMode == UNORDERED_REMOVAL)
+	{
+		if(pointIndex != _setSize - 1)
+		{
+			_array[pointIndex] = _array[_setSize - 1];
+			_index.setPosition(_array[pointIndex].getX(), _array[pointIndex].getY(), pointIndex);
+		}
+	}
+	else
+	{
+		memmove(_array + pointIndex, _array + pointIndex + 1,
+		        sizeof(BasicPoint<Coordinate>) * (_setSize - pointIndex - 1));
+		for(int i = pointIndex; i < _setSize - 1; i++)
+		{
+			_index.setPosition(_array[i].getX(), _array[i].getY(), i);
+		}
 	}
 	_setSize --;
+	_removeFromFingerprint(removed);
+	for(size_t i = 0; i < _observers.size(); i++)
+	{
+		_observers[i] -> pointRemoved(removed);
+	}
 	return true;
 }
 
 
 /** Removes the last n points from the set. Requires n to be smaller or
  * equal to the size of the set */
-void PointSet::trim(const int n)
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::trim(const int n)
 {
+	_compact();
 	for(int i = 0; i < n; i++)
 	{
-		delete(_array[_setSize-1-i]);
-		_array[_setSize-1-i] = nullptr;
+		_index.erase(_array[_setSize-1-i].getX(), _array[_setSize-1-i].getY());
+		_removeFromFingerprint(_array[_setSize-1-i]);
 	}
 	_setSize -= n;
+	for(size_t j = 0; j < _observers.size(); j++)
+	{
+		for(int i = 0; i < n; i++)
+		{
+			_observers[j] -> pointRemoved(_array[_setSize + i]);
+		}
+	}
+}
+
+
+/** Removes all the points from the set. The array and the hash index keep
+ * their capacity, and the observers are notified as by an assignment. */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::clear()
+{
+	_clearPoints();
+	_notifyReset();
+}
+
+
+/** Empties the array, the index and the fingerprint, without notifying the
+ * observers */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::_clearPoints()
+{
+	_setSize = 0;
+	_removedPlaces.clear();
+	_index.clear();
+	_fingerprintSum = 0;
+	_fingerprintXor = 0;
 }
 
 
 /** Returns the number of points currently in the set*/
-int PointSet::size() const
+template <typename Coordinate>
+int BasicPointSet<Coordinate>::size() const
 {
 	return _setSize;
 }
 
 
+/** Sets the way points are removed from the set. The points removed so far in
+ * the LAZY_REMOVAL mode are compacted first. */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::setRemovalMode(const RemovalMode mode)
+{
+	_compact();
+	_removalMode = mode;
+}
+
+
+/** Returns the way points are removed from the set */
+template <typename Coordinate>
+RemovalMode BasicPointSet<Coordinate>::getRemovalMode() const
+{
+	return _removalMode;
+}
+
+
+/** Returns the number of places in the array taken by points and by removed
+ * points that weren't compacted yet */
+template <typename Coordinate>
+int BasicPointSet<Coordinate>::_usedPlaces() const
+{
+	return _setSize + (int)_removedPlaces.size();
+}
+
+
+/** Moves the points of the set back over the places of the removed points, in
+ * a single pass from the first removed place, keeping their order. The hash
+ * index is updated with the new index of every moved point. */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::_compact() const
+{
+	if(_removedPlaces.empty())
+	{
+		return;
+	}
+
+	sort(_removedPlaces.begin(), _removedPlaces.end());
+	int usedPlaces = _usedPlaces();
+	int next = _removedPlaces[0];
+	size_t removed = 0;
+	for(int i = _removedPlaces[0]; i < usedPlaces; i++)
+	{
+		if(removed < _removedPlaces.size() and _removedPlaces[removed] == i)
+		{
+			removed++;
+			continue;
+		}
+		_array[next] = _array[i];
+		_index.setPosition(_array[next].getX(), _array[next].getY(), next);
+		next++;
+	}
+	_removedPlaces.clear();
+}
+
+
+/** Compacts the set and returns it */
+template <typename Coordinate>
+const BasicPointSet<Coordinate>& BasicPointSet<Coordinate>::_compacted() const
+{
+	_compact();
+	return *this;
+}
+
+
+/** Returns the array holding the points of the set contiguously, in the
+ * order of the set. */
+template <typename Coordinate>
+const BasicPoint<Coordinate>* BasicPointSet<Coordinate>::getPoints() const
+{
+	_compact();
+	return _array;
+}
+
+
+/**
+ * Functor that adapts a comparator of Point pointers to compare the Points
+ * stored by value in the array, so it can be passed to the standard
+ * algorithms.
+ */
+template <typename PointerComparator>
+class ValueComparator
+{
+public:
+	ValueComparator(const PointerComparator& comparator): _comparator(comparator){}
+
+	template <typename Coordinate>
+	bool operator()(const BasicPoint<Coordinate>& p1, const BasicPoint<Coordinate>& p2) const
+	{
+		const BasicPoint<Coordinate>* pointer1 = &p1;
+		const BasicPoint<Coordinate>* pointer2 = &p2;
+		return _comparator(pointer1, pointer2);
+	}
+
+private:
+	const PointerComparator& _comparator;
+};
+
+
+/** Wraps the given pointer comparator in a ValueComparator */
+template <typename PointerComparator>
+static ValueComparator<PointerComparator> byValue(const PointerComparator& comparator)
+{
+	return ValueComparator<PointerComparator>(comparator);
+}
+
+
 /**
  * Returns the minimal point in the set according to the given comparator
  * function. Returns a nullptr if set is empty.
  */
-const Point* PointSet::getMinimum(bool (*const comparatorFunction)(const Point*& p1,
-                                  const Point*& p2)) const
+template <typename Coordinate>
+const BasicPoint<Coordinate>* BasicPointSet<Coordinate>::getMinimum(bool (*const comparatorFunction)(
+                                                                    const BasicPoint<Coordinate>*& p1,
+                                                                    const BasicPoint<Coordinate>*& p2)) const
 {
+	_compact();
 	if(_setSize == 0)
 	{
 		return nullptr;
 	}
-	return *min_element(_array, _array + _setSize,
-			*comparatorFunction);
+	return min_element(_array, _array + _setSize, byValue(comparatorFunction));
+}
+
+
+/** y-coordinate Point comparator. Points are compared by the y coordinate,
+ * with ties broken by the x coordinate
+ */
+template <typename Coordinate>
+bool yCoordinateComparator(const BasicPoint<Coordinate>*& p1, const BasicPoint<Coordinate>*& p2)
+{
+	if(p1 -> getY() == p2 -> getY())
+	{
+		return p1 -> getX() < p2 -> getX();
+	}
+	return p1 -> getY() < p2 -> getY();
+}
+
+
+/** x-coordinate Point comparator. Points are compared by the x coordinate,
+ * with ties broken by the y coordinate
+ */
+template <typename Coordinate>
+bool xCoordinateComparator(const BasicPoint<Coordinate>*& p1, const BasicPoint<Coordinate>*& p2)
+{
+	if(p1 -> getX() == p2 -> getX())
+	{
+		return p1 -> getY() < p2 -> getY();
+	}
+	return p1 -> getX() < p2 -> getX();
+}
+
+
+/* Arrays shorter than this are sorted by comparisons even when sorted by a
+ * coordinate comparator, as the counting of the radix sort would cost more
+ * than it saves on them */
+static const int RADIX_SORT_THRESHOLD = 256;
+
+/* The radix sort runs over the 64 bit keys one digit at a time, from the least
+ * significant digit */
+static const int RADIX_BITS = 8;
+static const int RADIX_BUCKETS = 1 << RADIX_BITS;
+static const int RADIX_PASSES = 64 / RADIX_BITS;
+
+/** Returns the key of a point with the given coordinates, such that the keys
+ * are ordered as the points by the major coordinate, with ties broken by the
+ * minor coordinate. Narrow coordinates are widened to 32 bits, and flipping
+ * the sign bits then orders them as unsigned integers. */
+static inline uint64_t coordinateKey(const int32_t major, const int32_t minor)
+{
+	return ((uint64_t)((uint32_t)major ^ 0x80000000u) << 32) | ((uint32_t)minor ^ 0x80000000u);
+}
+
+
+/** Returns the major coordinate of the given key */
+static inline int32_t majorCoordinate(const uint64_t key)
+{
+	return (int32_t)((uint32_t)(key >> 32) ^ 0x80000000u);
+}
+
+
+/** Returns the minor coordinate of the given key */
+static inline int32_t minorCoordinate(const uint64_t key)
+{
+	return (int32_t)((uint32_t)key ^ 0x80000000u);
+}
+
+
+/**
+ * Sorts the given keys by an LSD radix sort, using the given buffer of the same
+ * size. The counts of all digits are taken in a single pass over the keys, and
+ * the passes over digits that are the same in all keys are skipped, so that
+ * small coordinates take fewer passes. The sorted keys end up in the given
+ * keys.
+ */
+static void radixSortKeys(vector<uint64_t>& keys, vector<uint64_t>& buffer)
+{
+	size_t n = keys.size();
+	vector<size_t> counts(RADIX_PASSES * RADIX_BUCKETS, 0);
+	for(size_t i = 0; i < n; i++)
+	{
+		uint64_t key = keys[i];
+		for(int pass = 0; pass < RADIX_PASSES; pass++)
+		{
+			counts[pass * RADIX_BUCKETS + ((key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1))]++;
+		}
+	}
+
+	for(int pass = 0; pass < RADIX_PASSES; pass++)
+	{
+		size_t* count = &counts[pass * RADIX_BUCKETS];
+		int shift = pass * RADIX_BITS;
+		if(count[(keys[0] >> shift) & (RADIX_BUCKETS - 1)] == n)
+		{
+			continue;
+		}
+
+		// Turning the counts into the first place of every digit
+		size_t place = 0;
+		for(int digit = 0; digit < RADIX_BUCKETS; digit++)
+		{
+			size_t digitCount = count[digit];
+			count[digit] = place;
+			place += digitCount;
+		}
+		for(size_t i = 0; i < n; i++)
+		{
+			buffer[count[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++] = keys[i];
+		}
+		keys.swap(buffer);
+	}
+}
+
+
+/**
+ * Sorts the given array of n points by the x coordinate if byX, and else by
+ * the y coordinate. The points are turned into keys holding both of their
+ * coordinates, which are radix sorted and turned back into points. A point
+ * consists of its coordinates alone, so nothing else has to move along with
+ * the keys. Requires the coordinates to be narrow.
+ */
+template <typename Coordinate>
+static void radixSortPoints(BasicPoint<Coordinate>* points, const int n, const bool byX)
+{
+	vector<uint64_t> keys(n);
+	vector<uint64_t> buffer(n);
+	for(int i = 0; i < n; i++)
+	{
+		keys[i] = byX ? coordinateKey(points[i].getX(), points[i].getY()) :
+		                coordinateKey(points[i].getY(), points[i].getX());
+	}
+	radixSortKeys(keys, buffer);
+	for(int i = 0; i < n; i++)
+	{
+		Coordinate major = (Coordinate)majorCoordinate(keys[i]);
+		Coordinate minor = (Coordinate)minorCoordinate(keys[i]);
+		points[i] = byX ? BasicPoint<Coordinate>(major, minor) : BasicPoint<Coordinate>(minor, major);
+	}
+}
+
+
+/** Sorts points of narrow coordinates by the given coordinate order, by the
+ * radix sort unless the array is short */
+template <typename Coordinate, typename Order>
+static void sortByOrder(BasicPoint<Coordinate>* points, const int n, const Order& order,
+                        const bool byX, true_type)
+{
+	if(n < RADIX_SORT_THRESHOLD)
+	{
+		sort(points, points + n, order);
+		return;
+	}
+	radixSortPoints(points, n, byX);
+}
+
+
+/** Sorts points of wide or floating coordinates by comparisons in the given
+ * coordinate order, which are inlined into the sort */
+template <typename Coordinate, typename Order>
+static void sortByOrder(BasicPoint<Coordinate>* points, const int n, const Order& order,
+                        const bool, false_type)
+{
+	sort(points, points + n, order);
+}
+
+
+/**
+ * Sorts the given array of n points by the x coordinate. Whether the radix
+ * sort can be used is decided at compile time by the coordinate type.
+ */
+template <typename Coordinate>
+void sortPoints(BasicPoint<Coordinate>* points, const int n, const XCoordinateOrder& order)
+{
+	sortByOrder(points, n, order, true, integral_constant<bool, CoordinateTraits<Coordinate>::isNarrow>());
+}
+
+
+/**
+ * Sorts the given array of n points by the y coordinate, in the same way
+ */
+template <typename Coordinate>
+void sortPoints(BasicPoint<Coordinate>* points, const int n, const YCoordinateOrder& order)
+{
+	sortByOrder(points, n, order, false, integral_constant<bool, CoordinateTraits<Coordinate>::isNarrow>());
+}
+
+
+/**
+ * Sorts the given array of n points according to the given comparator. The
+ * coordinate comparators are recognized by their addresses, and the points
+ * are then sorted by the matching coordinate order. Otherwise a comparison
+ * sort is used.
+ */
+template <typename Coordinate>
+void sortPoints(BasicPoint<Coordinate>* points, const int n,
+                bool (*const comparator)(const BasicPoint<Coordinate>*& p1,
+                const BasicPoint<Coordinate>*& p2))
+{
+	if(comparator == xCoordinateComparator<Coordinate>)
+	{
+		sortPoints(points, n, XCoordinateOrder());
+	}
+	else if(comparator == yCoordinateComparator<Coordinate>)
+	{
+		sortPoints(points, n, YCoordinateOrder());
+	}
+	else
+	{
+		sort(points, points + n, byValue(comparator));
+	}
 }
 
 
 /**
  * Sorts the set according to the given PivotComparator object.
  */
-void PointSet::sortSet(const PivotComparator& comparator)
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::sortSet(const PivotComparator& comparator)
 {
-	sort(_array, _array + _setSize, comparator);
+	_compact();
+	sort(_array, _array + _setSize, byValue(comparator));
+	_rebuildIndex();
 }
 
 
 /**
- * Sorts the set according to a given boolean function
+ * Sorts the set according to a given boolean function. The coordinate
+ * comparators are recognized by sortPoints, which then sorts in linear time.
  */
-void PointSet::sortSet(bool (*const comparator)(const Point*& p1, const Point*& p2))
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::sortSet(bool (*const comparator)(const BasicPoint<Coordinate>*& p1,
+                                                                 const BasicPoint<Coordinate>*& p2))
 {
-	sort(_array, _array + _setSize, comparator);
+	_compact();
+	sortPoints(_array, _setSize, comparator);
+	_rebuildIndex();
 }
 
 
@@ -205,10 +957,11 @@ void PointSet::sortSet(bool (*const comparator)(const Point*& p1, const Point*&
  * function that performs a comparison between two points, given the known
  * pivot point.
  */
-PointSet::PivotComparator::PivotComparator(const Point& pivot, 
-                                           bool(*const comparatorFunction)(const Point*& p1,
-                                           const Point*& p2, const Point& pivot)):
-                                           _pivot(pivot), _comparatorFunction(comparatorFunction){} 
+template <typename Coordinate>
+BasicPointSet<Coordinate>::PivotComparator::PivotComparator(const BasicPoint<Coordinate>& pivot,
+                           bool(*const comparatorFunction)(const BasicPoint<Coordinate>*& p1,
+                           const BasicPoint<Coordinate>*& p2, const BasicPoint<Coordinate>& pivot)):
+                           _pivot(pivot), _comparatorFunction(comparatorFunction){} 
 
 
 /**
@@ -216,49 +969,69 @@ PointSet::PivotComparator::PivotComparator(const Point& pivot,
  * Calling the object using () will result in comparing two objects given
  * the pivot, according to the comparator function held by the object
  */
-bool PointSet::PivotComparator::operator()(const Point*& p1, const Point*& p2) const
+template <typename Coordinate>
+bool BasicPointSet<Coordinate>::PivotComparator::operator()(const BasicPoint<Coordinate>*& p1,
+                                                            const BasicPoint<Coordinate>*& p2) const
 {
+	HULL_COUNT(POLAR_COMPARISONS, 1);
 	return _comparatorFunction(p1, p2, _pivot);
 }
 
 
 /** Returns the pointer in the given index. */
-const Point* PointSet::operator[] (const int index)
+template <typename Coordinate>
+const BasicPoint<Coordinate>* BasicPointSet<Coordinate>::operator[] (const int index)
 {
+	_compact();
 	assert(_validIndex(index));
-	return _array[index];
+	return _array + index;
 }
 
 
 /** Swaps between the location of two points in the set, according to the
  * given indexes */
-void PointSet::swapPoints(const int i, const int j)
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::swapPoints(const int i, const int j)
 {
-	
+	_compact();
 	assert(_validIndex(i) and _validIndex(j));
 	swap(_array[i], _array[j]);
+	_index.setPosition(_array[i].getX(), _array[i].getY(), i);
+	_index.setPosition(_array[j].getX(), _array[j].getY(), j);
 }
 
 
 /** Checks if the given index exists in the array */
-bool PointSet::_validIndex(int index) const
+template <typename Coordinate>
+bool BasicPointSet<Coordinate>::_validIndex(int index) const
 {
 	return 0 <= index and index < _setSize;
 }
 
 
 /** Checks if the given set has the exact same points as self, disregarding
- * order */
-bool PointSet::_isSameSet(const PointSet& other) const
+ * order. Sets of different sizes or fingerprints are told apart in O(1).
+ * Otherwise the sets are compared exactly: at once if their arrays are the
+ * same, as with a set and its unmodified copy, and else by probing for every
+ * point in the index of the given set. */
+template <typename Coordinate>
+bool BasicPointSet<Coordinate>::_isSameSet(const BasicPointSet& other) const
 {
-	if(_setSize != other.size())
+	if(_setSize != other.size() or _fingerprintSum != other._fingerprintSum or
+	   _fingerprintXor != other._fingerprintXor)
 	{
 		return false;
 	}
+	_compact();
+	other._compact();
+	if(_setSize == 0 or memcmp(_array, other._array, sizeof(BasicPoint<Coordinate>) * _setSize) == 0)
+	{
+		return true;
+	}
 
 	for(int i = 0; i < _setSize; i++)
 	{
-		if(other.getIndex(*_array[i]) == POINT_NOT_FOUND)
+		if(other.getIndex(_array[i]) == POINT_NOT_FOUND)
 		{
 			return false;
 		}
@@ -271,7 +1044,8 @@ bool PointSet::_isSameSet(const PointSet& other) const
  * Destroys current set and reloads it with the points in the given set,
  * with the same order
  */
-bool PointSet::operator==(const PointSet& other) const
+template <typename Coordinate>
+bool BasicPointSet<Coordinate>::operator==(const BasicPointSet& other) const
 {
 	return _isSameSet(other);
 }
@@ -281,7 +1055,8 @@ bool PointSet::operator==(const PointSet& other) const
  * Standard != overloader. Returns true iff both sets don't contain exactly
  * the same points (disregarding the order within the sets)
  */
-bool PointSet::operator!=(const PointSet& other) const
+template <typename Coordinate>
+bool BasicPointSet<Coordinate>::operator!=(const BasicPointSet& other) const
 {
 	return !_isSameSet(other);
 }
@@ -289,17 +1064,22 @@ bool PointSet::operator!=(const PointSet& other) const
 
 /** 
  * Returns a new PointSet object containing all the points in self,
- * excluding the points in the given set.
+ * excluding the points in the given set. Every point of self is probed for in
+ * the hash index of the given set, so this takes O(n + m) expected time. The
+ * result is presized to the size of self, so it is allocated once.
  */
-PointSet PointSet::operator-(const PointSet& other) const
+template <typename Coordinate>
+BasicPointSet<Coordinate> BasicPointSet<Coordinate>::operator-(const BasicPointSet& other) const
 {
-	PointSet newSet;
-
-	for(int i = 0; i <  _setSize; i++)
+	_compact();
+	other._compact();
+	BasicPointSet newSet;
+	newSet.reserve(_setSize);
+	for(int i = 0; i < _setSize; i++)
 	{
-		if(other.getIndex(*_array[i]) == POINT_NOT_FOUND)
+		if(other.getIndex(_array[i]) == POINT_NOT_FOUND)
 		{
-			newSet.add(*_array[i]);
+			newSet._append(_array[i]);
 		}
 	}
 	return newSet;
@@ -308,35 +1088,187 @@ PointSet PointSet::operator-(const PointSet& other) const
 
 /** 
  * Returns a new PointSet object containing all the points that are both in self,
- * and in the given set.
+ * and in the given set. Takes O(n + m) expected time, like operator-, and
+ * the result is presized to the smaller of the two sets.
  */
-PointSet PointSet::operator&(const PointSet& other) const
+template <typename Coordinate>
+BasicPointSet<Coordinate> BasicPointSet<Coordinate>::operator&(const BasicPointSet& other) const
 {
-	PointSet newSet;
+	_compact();
+	other._compact();
+	BasicPointSet newSet;
+	newSet.reserve(min(_setSize, other._setSize));
+	for(int i = 0; i < _setSize; i++)
+	{
+		if(other.getIndex(_array[i]) != POINT_NOT_FOUND)
+		{
+			newSet._append(_array[i]);
+		}
+	}
+	return newSet;
+}
+
+
+/**
+ * Returns a new PointSet object containing all the points that are in self
+ * or in the given set. The points of self are unique, so they are appended
+ * without being probed for, and only the points of the given set are probed
+ * for in self. Takes O(n + m) expected time.
+ */
+template <typename Coordinate>
+BasicPointSet<Coordinate> BasicPointSet<Coordinate>::operator|(const BasicPointSet& other) const
+{
+	_compact();
+	other._compact();
+	BasicPointSet newSet;
+	newSet.reserve(_setSize + other._setSize);
+	for(int i = 0; i < _setSize; i++)
+	{
+		newSet._append(_array[i]);
+	}
+	for(int i = 0; i < other._setSize; i++)
+	{
+		if(getIndex(other._array[i]) == POINT_NOT_FOUND)
+		{
+			newSet._append(other._array[i]);
+		}
+	}
+	return newSet;
+}
+
 
+/**
+ * Returns a new PointSet object containing all the points that are in
+ * exactly one of self and the given set. Takes O(n + m) expected time.
+ */
+template <typename Coordinate>
+BasicPointSet<Coordinate> BasicPointSet<Coordinate>::operator^(const BasicPointSet& other) const
+{
+	_compact();
+	other._compact();
+	BasicPointSet newSet;
+	newSet.reserve(_setSize + other._setSize);
 	for(int i = 0; i < _setSize; i++)
 	{
-		if(other.getIndex(*_array[i]) != POINT_NOT_FOUND)
+		if(other.getIndex(_array[i]) == POINT_NOT_FOUND)
 		{
-			newSet.add(*_array[i]);
+			newSet._append(_array[i]);
+		}
+	}
+	for(int i = 0; i < other._setSize; i++)
+	{
+		if(getIndex(other._array[i]) == POINT_NOT_FOUND)
+		{
+			newSet._append(other._array[i]);
 		}
 	}
 	return newSet;
 }
 
 
-/** Swaps between the data of the given sets. */
-void swapSets(PointSet& a, PointSet& b)
+/** Swaps between the data of the given sets. The observers and the removal
+ * modes stay with their sets, and the observers are notified that the points
+ * of their set were reset. Both sets are compacted first. */
+template <typename Coordinate>
+void swapSets(BasicPointSet<Coordinate>& a, BasicPointSet<Coordinate>& b)
 {
+	a._compact();
+	b._compact();
 	swap(a._setSize, b._setSize);
 	swap(a._arraySize, b._arraySize);
 	swap(a._array, b._array);
-	
+	swap(a._ownsArray, b._ownsArray);
+	swapIndexes(a._index, b._index);
+	swap(a._fingerprintSum, b._fingerprintSum);
+	swap(a._fingerprintXor, b._fingerprintXor);
+	a._notifyReset();
+	b._notifyReset();
+}
+
+
+/** Attaches the given observer to the set, to be notified of every change to
+ * the points of the set. */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::addObserver(BasicPointSetObserver<Coordinate>* observer)
+{
+	_observers.push_back(observer);
+}
+
+
+/** Detaches the given observer from the set */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::removeObserver(BasicPointSetObserver<Coordinate>* observer)
+{
+	_observers.erase(std::remove(_observers.begin(), _observers.end(), observer),
+	                 _observers.end());
+}
+
+
+/** Notifies the observers that the set was reset */
+template <typename Coordinate>
+void BasicPointSet<Coordinate>::_notifyReset() const
+{
+	for(size_t i = 0; i < _observers.size(); i++)
+	{
+		_observers[i] -> setReset(*this);
+	}
 }
 
 
-PointSet& PointSet::operator=(PointSet other)
+/**
+ * Destroys current set and reloads it with the points in the given set, with
+ * the same order. The given set is copied, and the copy swapped in.
+ */
+template <typename Coordinate>
+BasicPointSet<Coordinate>& BasicPointSet<Coordinate>::operator=(const BasicPointSet& other)
 {
-	swapSets(*this, other);
+	BasicPointSet copy(other);
+	swapSets(*this, copy);
 	return *this;
 }
+
+
+/**
+ * Destroys current set and takes over the points of the given set. The points
+ * are moved into a temporary set, which is swapped in, so the given set is
+ * left empty and the old points of this set are freed with the temporary.
+ */
+template <typename Coordinate>
+BasicPointSet<Coordinate>& BasicPointSet<Coordinate>::operator=(BasicPointSet&& other)
+{
+	if(this != &other)
+	{
+		BasicPointSet moved(move(other));
+		swapSets(*this, moved);
+	}
+	return *this;
+}
+
+
+template class BasicPointSet<int16_t>;
+template class BasicPointSet<int32_t>;
+template class BasicPointSet<int64_t>;
+template class BasicPointSet<double>;
+
+template void swapSets(BasicPointSet<int16_t>& a, BasicPointSet<int16_t>& b);
+template void swapSets(BasicPointSet<int32_t>& a, BasicPointSet<int32_t>& b);
+template void swapSets(BasicPointSet<int64_t>& a, BasicPointSet<int64_t>& b);
+template void swapSets(BasicPointSet<double>& a, BasicPointSet<double>& b);
+
+#define INSTANTIATE_POINT_FUNCTIONS(Coordinate) \
+	template bool xCoordinateComparator(const BasicPoint<Coordinate>*& p1, \
+	                                    const BasicPoint<Coordinate>*& p2); \
+	template bool yCoordinateComparator(const BasicPoint<Coordinate>*& p1, \
+	                                    const BasicPoint<Coordinate>*& p2); \
+	template void sortPoints(BasicPoint<Coordinate>* points, const int n, \
+	                         const XCoordinateOrder& order); \
+	template void sortPoints(BasicPoint<Coordinate>* points, const int n, \
+	                         const YCoordinateOrder& order); \
+	template void sortPoints(BasicPoint<Coordinate>* points, const int n, \
+	                         bool (*const comparator)(const BasicPoint<Coordinate>*& p1, \
+	                         const BasicPoint<Coordinate>*& p2));
+
+INSTANTIATE_POINT_FUNCTIONS(int16_t)
+INSTANTIATE_POINT_FUNCTIONS(int32_t)
+INSTANTIATE_POINT_FUNCTIONS(int64_t)
+INSTANTIATE_POINT_FUNCTIONS(double)
@@ -3,21 +3,138 @@
 #define POINT_SET_H
 
 #include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
 #include "Point.h"
+#include "PointHashIndex.h"
+#include "PointSetObserver.h"
 
 using namespace std;
 
 static const int POINT_NOT_FOUND = -1;
+
 /**
- * This class represents an ordered set of Point objects, with no duplicates.
+ * The ways in which BasicPointSet::remove can treat the points that follow the
+ * removed one:
+ * ORDERED_REMOVAL - The following points are moved one place back, keeping the
+ *                   order of the set. Takes O(n) time per removal.
+ * UNORDERED_REMOVAL - The last point of the set is moved into the place of the
+ *                     removed one, so only that point changes its place. Takes
+ *                     O(1) expected time per removal.
+ * LAZY_REMOVAL - The removed point is only marked as removed, and the marked
+ *                places are compacted all at once, keeping the order of the
+ *                set, when the points are next accessed by their indexes.
+ *                Takes O(1) expected time per removal, and O(n) time per
+ *                compaction. Since the const methods compact the set as
+ *                well, a set with pending lazy removals must not be read
+ *                concurrently, even through const methods.
+ */
+enum RemovalMode {ORDERED_REMOVAL, UNORDERED_REMOVAL, LAZY_REMOVAL};
+
+template <typename Coordinate>
+class BasicPointSet;
+
+/** Swaps between the data of the given sets. */
+template <typename Coordinate>
+void swapSets(BasicPointSet<Coordinate>& a, BasicPointSet<Coordinate>& b);
+
+/** y-coordinate Point comparator. Points are compared by the y coordinate,
+ * with ties broken by the x coordinate
+ */
+template <typename Coordinate>
+bool yCoordinateComparator(const BasicPoint<Coordinate>*& p1, const BasicPoint<Coordinate>*& p2);
+
+/** x-coordinate Point comparator. Points are compared by the x coordinate,
+ * with ties broken by the y coordinate
  */
+template <typename Coordinate>
+bool xCoordinateComparator(const BasicPoint<Coordinate>*& p1, const BasicPoint<Coordinate>*& p2);
 
-class PointSet
+/**
+ * Function object comparing points held by value by the x coordinate, with
+ * ties broken by the y coordinate. Same as xCoordinateComparator, but can be
+ * inlined into the sorts and searches it is passed to.
+ */
+struct XCoordinateOrder
+{
+	template <typename Coordinate>
+	bool operator()(const BasicPoint<Coordinate>& p1, const BasicPoint<Coordinate>& p2) const
+	{
+		if(p1.getX() == p2.getX())
+		{
+			return p1.getY() < p2.getY();
+		}
+		return p1.getX() < p2.getX();
+	}
+};
+
+/**
+ * Function object comparing points held by value by the y coordinate, with
+ * ties broken by the x coordinate. Same as yCoordinateComparator, but can be
+ * inlined into the sorts and searches it is passed to.
+ */
+struct YCoordinateOrder
+{
+	template <typename Coordinate>
+	bool operator()(const BasicPoint<Coordinate>& p1, const BasicPoint<Coordinate>& p2) const
+	{
+		if(p1.getY() == p2.getY())
+		{
+			return p1.getX() < p2.getX();
+		}
+		return p1.getY() < p2.getY();
+	}
+};
+
+/**
+ * Sorts the given array of n points by the x coordinate, and secondly by the
+ * y coordinate. Large arrays of narrow integer coordinates are sorted by a
+ * radix sort in linear time, and any other array by comparisons.
+ */
+template <typename Coordinate>
+void sortPoints(BasicPoint<Coordinate>* points, const int n, const XCoordinateOrder& order);
+
+/**
+ * Sorts the given array of n points by the y coordinate, and secondly by the
+ * x coordinate, in the same way
+ */
+template <typename Coordinate>
+void sortPoints(BasicPoint<Coordinate>* points, const int n, const YCoordinateOrder& order);
+
+/**
+ * Sorts the given array of n points according to the given comparator. The
+ * coordinate comparators above are recognized, and sorted by as their
+ * orders. Any other comparator is used by a comparison sort.
+ */
+template <typename Coordinate>
+void sortPoints(BasicPoint<Coordinate>* points, const int n,
+                bool (*const comparator)(const BasicPoint<Coordinate>*& p1,
+                const BasicPoint<Coordinate>*& p2));
+
+/**
+ * Sorts the given array of n points according to the given function object,
+ * by comparisons
+ */
+template <typename Coordinate, typename Comparator>
+void sortPoints(BasicPoint<Coordinate>* points, const int n, const Comparator& comparator)
+{
+	sort(points, points + n, comparator);
+}
+
+/**
+ * This class represents an ordered set of points with coordinates of the given
+ * type, with no duplicates. The set is instantiated for the coordinate types
+ * int16_t, int32_t, int64_t and double, and the hull algorithms work on
+ * PointSet, the set of int coordinates.
+ */
+template <typename Coordinate>
+class BasicPointSet
 {
 public:
 
 	/** Swaps between the data of the given sets. */
-	friend void swapSets(PointSet& a, PointSet& b);
+	friend void swapSets<>(BasicPointSet& a, BasicPointSet& b);
 
 
 	/** Functor object for comparing two points according to a known pivot
@@ -32,46 +149,60 @@ public:
 		 * function that performs a comparison between two points, given the known
 		 * pivot point.
 		 */
-		PivotComparator(const Point& pivot,
-                        bool (*const comparatorFunction)(const Point*& p1, 
-                        const Point*& p2, const Point& pivot));
+		PivotComparator(const BasicPoint<Coordinate>& pivot,
+                        bool (*const comparatorFunction)(const BasicPoint<Coordinate>*& p1,
+                        const BasicPoint<Coordinate>*& p2, const BasicPoint<Coordinate>& pivot));
 
 		/**
 		 * Overloads the () operator in order to provide the functor capability.
 		 * Calling the object using () will result in comparing two objects given
 		 * the pivot, according to the comparator function held by the object
 		 */
-		bool operator()(const Point*& p1, const Point*& p2) const;
+		bool operator()(const BasicPoint<Coordinate>*& p1, const BasicPoint<Coordinate>*& p2) const;
 
 
 
 	private:
-		const Point& _pivot;
-		bool (* const _comparatorFunction)(const Point*& p1, const Point*& p2,
-                                                   const Point& pivot);
+		const BasicPoint<Coordinate>& _pivot;
+		bool (* const _comparatorFunction)(const BasicPoint<Coordinate>*& p1,
+		                                   const BasicPoint<Coordinate>*& p2,
+		                                   const BasicPoint<Coordinate>& pivot);
 	};
 
 	/**
 	 * Default Constructor
 	 */
-	PointSet();
+	BasicPointSet();
 
 	/**
 	 * Constructor with passed values. The size of the set and the array are
 	 * defined.
 	 */
-	PointSet(const int setSize, const int arraySize);
+	BasicPointSet(const int setSize, const int arraySize);
+
+	/**
+	 * Constructs a set from a buffer of n points, given as consecutive pairs of
+	 * coordinates: x0, y0, x1, y1 and so on. Duplicate points are dropped,
+	 * keeping the first occurrence.
+	 */
+	BasicPointSet(const Coordinate* coordinates, const int n);
 
 	/**
 	 * Copy Constructor, creates an object with the same points and order as
 	 * the given object
 	 */
-	PointSet(const PointSet& other);
+	BasicPointSet(const BasicPointSet& other);
+
+	/**
+	 * Move Constructor, takes over the points of the given set without
+	 * copying them, leaving the given set empty
+	 */
+	BasicPointSet(BasicPointSet&& other);
 
 	/**
 	 * Destructor
 	 */
-	~PointSet();
+	~BasicPointSet();
 
 	/**
 	 * Returns a string specifying the coordinates of all Points in the set
@@ -82,80 +213,191 @@ public:
 	 * Adds given point to the set iff it doesn't currently exist in the set. 
 	 * @return True iff Point was added to the set
 	 */
-	bool add(const Point& point);
+	bool add(const BasicPoint<Coordinate>& point);
 	
 	/**
 	 * Removes given point from the set.
 	 * @return True iff point was removed from the set(i.e. if it was in the
 	 * set to begin with
 	 */
-	bool remove(const Point& point);
+	bool remove(const BasicPoint<Coordinate>& point);
+
+	/**
+	 * Adds the points in the range [begin, end) that aren't in the set, in
+	 * order, keeping the first occurrence of points repeated in the range. The
+	 * array and the hash index grow at most once for the whole range.
+	 * @return The number of points added
+	 */
+	int addRange(const BasicPoint<Coordinate>* begin, const BasicPoint<Coordinate>* end);
+
+	/**
+	 * Replaces the points of the set with the points in the range
+	 * [begin, end), in order, keeping the first occurrence of points repeated
+	 * in the range.
+	 */
+	void assign(const BasicPoint<Coordinate>* begin, const BasicPoint<Coordinate>* end);
+
+	/**
+	 * Replaces the points of the set with the n points of the given array, and
+	 * holds them in that array in place, without copying them. Repeated points
+	 * are dropped after their first occurrence. The array isn't freed by the
+	 * set, and must stay valid and writable as long as the set holds its
+	 * points in it: until the set grows beyond n points or is shrunk, when the
+	 * points are copied into an array of the set's own.
+	 */
+	void adopt(BasicPoint<Coordinate>* points, const int n);
 
 	/** Removes the last n points from the set. Requires n to be smaller or
 	 * equal to the size of the set */
 	void trim(const int n);
+
+	/** Removes all the points from the set, keeping its array and hash index
+	 * for the points added next, so that a set refilled with about as many
+	 * points takes no allocations */
+	void clear();
 	
 	/** Returns the number of points currently in the set*/
 	int size() const;
 
+	/** Sets the way points are removed from the set. The default is
+	 * ORDERED_REMOVAL. The mode is copied along with the set, but isn't
+	 * changed by assignments. */
+	void setRemovalMode(const RemovalMode mode);
+
+	/** Returns the way points are removed from the set */
+	RemovalMode getRemovalMode() const;
+
+	/** Returns the number of points the set can hold before its array has to
+	 * grow */
+	int capacity() const;
+
+	/** Makes sure n points can be held without growing the array or the hash
+	 * index */
+	void reserve(const int n);
+
+	/** Shrinks the array and the hash index to the smallest sizes that hold
+	 * the current points */
+	void shrinkToFit();
+
+	/** Returns the array holding the points of the set contiguously, in the
+	 * order of the set. The pointer is only valid until the set is next
+	 * modified. */
+	const BasicPoint<Coordinate>* getPoints() const;
+
 	/**
 	 * Sorts the set according to the given PivotComparator object.
 	 */
 	void sortSet(const PivotComparator& comparator);
 
 	/**
-	 * Sorts the set according to a given boolean function
+	 * Sorts the set according to a given boolean function. Sorting by one of
+	 * the coordinate comparators takes linear time.
 	 */
-	void sortSet(bool (*const comparator)(const Point*& p1, const Point*& p2));
+	void sortSet(bool (*const comparator)(const BasicPoint<Coordinate>*& p1,
+	                                      const BasicPoint<Coordinate>*& p2));
+
+	/**
+	 * Sorts the set according to the given function object, which receives
+	 * two points and returns true iff the first comes before the second. The
+	 * calls to the function object can be inlined by the sort, unlike calls
+	 * through function pointers. Sorting by XCoordinateOrder or
+	 * YCoordinateOrder takes linear time.
+	 */
+	template <typename Comparator>
+	void sortSet(const Comparator& comparator);
+
+	/**
+	 * Sorts the set according to keys computed by the given function object,
+	 * which receives a Point and returns its key. The key of every point is
+	 * computed once, and the keys are then compared with the < operator.
+	 */
+	template <typename KeyFunction>
+	void sortByKey(const KeyFunction& keyFunction);
 
 	/**
 	 * Returns the minimal point in the set according to the given comparator
-	 * function. Returns a nullptr if set is empty.
+	 * function. Returns a nullptr if set is empty. The returned pointer points
+	 * into the set, and is only valid until the set is next modified.
+	 */
+	const BasicPoint<Coordinate>* getMinimum (bool (*const comparatorFunction)(
+	                                          const BasicPoint<Coordinate>*& p1,
+	                                          const BasicPoint<Coordinate>*& p2)) const;
+
+	/**
+	 * Returns the minimal point in the set according to the given function
+	 * object, which compares two points like the ones given to sortSet.
+	 * Returns a nullptr if set is empty.
 	 */
-	const Point* getMinimum (bool (*const comparatorFunction)(const Point*& p1, const Point*& p2)) const;
+	template <typename Comparator>
+	const BasicPoint<Coordinate>* getMinimum(const Comparator& comparator) const;
 	
-	/** Returns the pointer in the given index. */
-	const Point* operator[] (const int index); 
+	/** Returns the pointer in the given index. The pointer points into the
+	 * set, and is only valid until the set is next modified. */
+	const BasicPoint<Coordinate>* operator[] (const int index); 
 	
 
 	/**
 	 * Standard == overloader. Returns true iff both sets contain exactly
 	 * the same points (disregarding the order within the sets)
 	 */
-	bool operator==(const PointSet& other) const;
+	bool operator==(const BasicPointSet& other) const;
 
 
 	/**
 	 * Standard != overloader. Returns true iff both sets don't contain exactly
-	 * the same points (disregarding the order within the sets)
+	 * the same points (disregarding the order within the sets). Sets with
+	 * different points are told apart in O(1) by their fingerprints.
 	 */
-	bool operator!=(const PointSet& other) const;
+	bool operator!=(const BasicPointSet& other) const;
 
 
 	/** 
 	 * Returns a new PointSet object containing all the points in self,
 	 * excluding the points in the given set.
 	 */
-	PointSet operator-(const PointSet& other) const; 
+	BasicPointSet operator-(const BasicPointSet& other) const; 
 	
 
 	/** 
 	 * Returns a new PointSet object containing all the points that are both in self,
 	 * and in the given set.
 	 */
-	PointSet operator&(const PointSet& other) const; 
+	BasicPointSet operator&(const BasicPointSet& other) const; 
+
+
+	/**
+	 * Returns a new PointSet object containing all the points that are in self
+	 * or in the given set: the points of self, followed by the points of the
+	 * given set that are not in self.
+	 */
+	BasicPointSet operator|(const BasicPointSet& other) const;
+
+
+	/**
+	 * Returns a new PointSet object containing all the points that are in
+	 * exactly one of self and the given set: the points of self that are not
+	 * in the given set, followed by the points of the given set that are not
+	 * in self.
+	 */
+	BasicPointSet operator^(const BasicPointSet& other) const;
 
 
 	/**
 	 * Destroys current set and reloads it with the points in the given set,
 	 * with the same order
 	 */
-	PointSet& operator=(PointSet other);
+	BasicPointSet& operator=(const BasicPointSet& other);
+
+	/**
+	 * Destroys current set and takes over the points of the given set without
+	 * copying them, leaving the given set empty
+	 */
+	BasicPointSet& operator=(BasicPointSet&& other);
 
 	
 	/** Returns the index of given point within the array. Returns -1 if no
 	 * Point is found. */
-	int getIndex(const Point& point) const;	
+	int getIndex(const BasicPoint<Coordinate>& point) const;	
 
 
 	/** Swaps between the location of two points in the set, according to the
@@ -163,16 +405,158 @@ public:
 	void swapPoints(const int i, const int j); 
 
 
+	/** Attaches the given observer to the set, to be notified of every change
+	 * to the points of the set. The observers are not copied along with the
+	 * set. */
+	void addObserver(BasicPointSetObserver<Coordinate>* observer);
+
+
+	/** Detaches the given observer from the set */
+	void removeObserver(BasicPointSetObserver<Coordinate>* observer);
+
+
 private:
 	int _setSize;
 	int _arraySize;
-	const Point * * _array;
+	BasicPoint<Coordinate> * _array; // The points are stored contiguously, by value
+	bool _ownsArray; // False while the array is one given to adopt
+	mutable BasicPointHashIndex<Coordinate> _index; // Maps every point in the set to its index
+	vector<BasicPointSetObserver<Coordinate>*> _observers;
+
+	/* An order independent fingerprint of the points in the set: the sum and
+	 * the xor of a 64 bit hash of every point. It is updated with every point
+	 * added or removed, so sets with different points are told apart in O(1) */
+	unsigned long long _fingerprintSum;
+	unsigned long long _fingerprintXor;
+
+	/* The places in the array of the points removed in the LAZY_REMOVAL mode
+	 * since the last compaction. The array then holds _setSize points
+	 * followed by these places, and is compacted before the points are
+	 * accessed by their indexes. Since the compaction doesn't change the
+	 * points of the set, it is done by const methods as well, which is why
+ * such a set can't be read by several threads at once. */
+	RemovalMode _removalMode;
+	mutable vector<int> _removedPlaces;
+
+	/** Allocates the array according to the array size, if it is positive */
+	void _allocateArray();
+
+	/** Resizes the array to hold the given number of points, copying them
+	 * into an array of the set's own if the array is borrowed */
+	void _resizeArray(const int size);
+
+	/** Adds the given point to the end of the set. Requires the point not to
+	 * be in the set, and the set to have room for it */
+	void _append(const BasicPoint<Coordinate>& point);
+
+	/** Adds the given point to the end of the set iff it isn't in the set,
+	 * without notifying the observers. Requires the set to have room for it.
+	 * @return True iff the point was added */
+	bool _appendIfAbsent(const BasicPoint<Coordinate>& point);
+
+	/** Makes room for n more points in the array and the hash index, growing
+	 * them at most once */
+	void _growFor(const int n);
+
+	/** Empties the hash index and reinserts every point with its current
+	 * index in the array */
+	void _rebuildIndex();
+
+	/** Adds the given point to the fingerprint of the set */
+	void _addToFingerprint(const BasicPoint<Coordinate>& point);
+
+	/** Removes the given point from the fingerprint of the set */
+	void _removeFromFingerprint(const BasicPoint<Coordinate>& point);
+
+	/** Returns the number of places in the array taken by points and by
+	 * removed points that weren't compacted yet */
+	int _usedPlaces() const;
+
+	/** Moves the points of the set back over the places of the removed
+	 * points, keeping their order */
+	void _compact() const;
+
+	/** Compacts the set and returns it */
+	const BasicPointSet& _compacted() const;
+
+	/** Notifies the observers that the set was reset */
+	void _notifyReset() const;
+
+	/** Empties the array, the index and the fingerprint, without notifying
+	 * the observers */
+	void _clearPoints();
 
 	/** Checks if the given index exists in the array */
 	bool _validIndex(int index) const;
 
 	/** Checks if the given set has the exact same points as self, disregarding
 	 * order */
-	bool _isSameSet(const PointSet& other) const;
+	bool _isSameSet(const BasicPointSet& other) const;
 };
+
+
+/**
+ * Sorts the set according to keys computed by the given function object. The
+ * points are sorted along with their keys, and then copied back into the array.
+ */
+template <typename Coordinate>
+template <typename KeyFunction>
+void BasicPointSet<Coordinate>::sortByKey(const KeyFunction& keyFunction)
+{
+	typedef decltype(keyFunction(*_array)) Key;
+	typedef pair<Key, BasicPoint<Coordinate> > KeyedPoint;
+
+	_compact();
+	vector<KeyedPoint> keyedPoints;
+	keyedPoints.reserve(_setSize);
+	for(int i = 0; i < _setSize; i++)
+	{
+		keyedPoints.push_back(KeyedPoint(keyFunction(_array[i]), _array[i]));
+	}
+
+	sort(keyedPoints.begin(), keyedPoints.end(),
+	     [](const KeyedPoint& p1, const KeyedPoint& p2) { return p1.first < p2.first; });
+
+	for(int i = 0; i < _setSize; i++)
+	{
+		_array[i] = keyedPoints[i].second;
+	}
+	_rebuildIndex();
+}
+
+
+/**
+ * Sorts the set according to the given function object, through sortPoints,
+ * which either sorts by comparisons with the function object or recognizes it
+ * as a coordinate order.
+ */
+template <typename Coordinate>
+template <typename Comparator>
+void BasicPointSet<Coordinate>::sortSet(const Comparator& comparator)
+{
+	_compact();
+	sortPoints(_array, _setSize, comparator);
+	_rebuildIndex();
+}
+
+
+/**
+ * Returns the minimal point in the set according to the given function object
+ */
+template <typename Coordinate>
+template <typename Comparator>
+const BasicPoint<Coordinate>* BasicPointSet<Coordinate>::getMinimum(const Comparator& comparator) const
+{
+	_compact();
+	if(_setSize == 0)
+	{
+		return nullptr;
+	}
+	return min_element(_array, _array + _setSize, comparator);
+}
+
+
+/** The sets used by the hull algorithms, with int coordinates */
+typedef BasicPointSet<int32_t> PointSet;
+
 #endif
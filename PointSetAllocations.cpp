@@ -0,0 +1,191 @@
+//PointSetAllocations.cpp
+
+/**
+ * This file tests the number of allocations taken by the copying, moving and
+ * capacity control of PointSet, so that regressions in the storage of the
+ * sets show up. It is linked with the malloc, realloc and free of the C
+ * library wrapped, and counts the calls made by the set and its hash index.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "Point.h"
+#include "PointSet.h"
+#include "TestUtils.h"
+using namespace std;
+
+extern "C"
+{
+	void* __real_malloc(size_t size);
+	void* __real_realloc(void* pointer, size_t size);
+	void __real_free(void* pointer);
+}
+
+static int allocations = 0;
+static int frees = 0;
+
+extern "C"
+{
+	/** Counts the allocation and forwards it to the C library */
+	void* __wrap_malloc(size_t size)
+	{
+		allocations++;
+		return __real_malloc(size);
+	}
+
+	/** Counts the reallocation and forwards it to the C library */
+	void* __wrap_realloc(void* pointer, size_t size)
+	{
+		allocations++;
+		return __real_realloc(pointer, size);
+	}
+
+	/** Counts the release and forwards it to the C library */
+	void __wrap_free(void* pointer)
+	{
+		if(pointer != nullptr)
+		{
+			frees++;
+		}
+		__real_free(pointer);
+	}
+}
+
+/** Prints the number of allocations taken since the last check, and whether it
+ * is the expected one, then resets the counters */
+static void checkAllocations(const char* description, const int expected)
+{
+	cout << description << ": " << allocations << " allocations, expected "
+	     << expected << (allocations == expected ? " OK" : " FAILED") << endl;
+	if(allocations != expected)
+	{
+		passed = false;
+	}
+	allocations = 0;
+	frees = 0;
+}
+
+/** Fills the given set with n points on a line */
+static void fill(PointSet& set, const int n, const int offset)
+{
+	for(int i = 0; i < n; i++)
+	{
+		set.add(Point(i + offset, 2 * (i + offset)));
+	}
+}
+
+int main()
+{
+	const int n = 1000;
+	allocations = 0;
+
+	PointSet empty;
+	PointSet emptyCopy(empty);
+	checkAllocations("Constructing and copying empty sets", 0);
+
+	PointSet a;
+	a.reserve(n);
+	fill(a, n, 0);
+	checkAllocations("Reserving and adding 1000 points", 2);
+	check("Reserved capacity holds the points", a.capacity() == n);
+
+	PointSet grown;
+	fill(grown, n, 0);
+	cout << "Adding 1000 points without reserving: " << allocations << " allocations" << endl;
+	check("Growing takes more allocations than reserving", allocations > 2);
+	allocations = 0;
+
+	vector<Point> points;
+	for(int i = 0; i < n; i++)
+	{
+		points.push_back(Point(i, 2 * i));
+		points.push_back(Point(i, 2 * i));
+	}
+	allocations = 0;
+	PointSet range;
+	range.addRange(points.data(), points.data() + points.size());
+	checkAllocations("Adding a range of 2000 points with 1000 repeated", 2);
+	check("Range holds the points once", range == a);
+	range.assign(points.data(), points.data() + n);
+	checkAllocations("Assigning a smaller range", 0);
+
+	range.clear();
+	check("Cleared set is empty", range.size() == 0 and range.getIndex(Point(0, 0)) == POINT_NOT_FOUND);
+	range.addRange(points.data(), points.data() + points.size());
+	checkAllocations("Clearing a set and adding the range again", 0);
+
+	PointSet b(a);
+	checkAllocations("Copying a set", 2);
+
+	PointSet moved(move(b));
+	checkAllocations("Moving a set", 0);
+	check("Moved set holds the points", moved.size() == n and moved == a);
+	check("Moved from set is empty", b.size() == 0 and b.capacity() == 0);
+
+	PointSet target;
+	fill(target, 10, 0);
+	allocations = 0;
+	frees = 0;
+	target = move(moved);
+	int releases = frees;
+	checkAllocations("Move assigning a set", 0);
+	check("Move assignment frees the old points", releases == 2);
+	check("Move assigned set holds the points", target == a and moved.size() == 0);
+
+	target = move(target);
+	checkAllocations("Move assigning a set to itself", 0);
+	check("Set stays the same", target == a);
+
+	b = a;
+	checkAllocations("Copy assigning a set", 2);
+
+	PointSet other;
+	fill(other, n / 2, n / 2);
+	allocations = 0;
+	PointSet difference = a - other;
+	checkAllocations("Computing a - other", 2);
+	PointSet intersection = a & other;
+	checkAllocations("Computing a & other", 2);
+	PointSet both = a | other;
+	checkAllocations("Computing a | other", 2);
+
+	check("Difference holds half of the points", difference.size() == n / 2);
+	difference.shrinkToFit();
+	checkAllocations("Shrinking the difference", 2);
+	check("Shrunk capacity fits the points", difference.capacity() == n / 2);
+	difference.shrinkToFit();
+	checkAllocations("Shrinking it again", 0);
+	fill(difference, n / 2, n);
+	check("Shrunk set still adds points", difference.size() == n);
+
+	allocations = 0;
+	frees = 0;
+	while(difference.size() > 0)
+	{
+		Point first = *difference[0];
+		difference.remove(first);
+	}
+	difference.shrinkToFit();
+	releases = frees;
+	checkAllocations("Shrinking an emptied set", 0);
+	check("Shrinking an emptied set frees its storage", releases == 2 and
+	      difference.capacity() == 0);
+
+	vector<Point> buffer(points);
+	allocations = 0;
+	PointSet adopted;
+	adopted.adopt(buffer.data(), (int)buffer.size());
+	checkAllocations("Adopting a buffer of 2000 points with 1000 repeated", 1);
+	check("Adopted set holds the points once, in place", adopted == a and
+	      adopted.getPoints() == buffer.data());
+	fill(adopted, n, n);
+	checkAllocations("Adding 1000 points within the adopted buffer", 0);
+	adopted.add(Point(-1, -1));
+	check("Growing beyond the buffer copies the points out", adopted.size() == 2 * n + 1 and
+	      adopted.getPoints() != buffer.data() and adopted.getIndex(Point(n, 2 * n)) == n);
+
+	cout << (passed ? "All allocation checks passed" : "Some allocation checks failed") << endl;
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,949 @@
+//PointSetBenchmark.cpp
+
+/**
+ * This program times the operations of PointSet and every stage of the hull
+ * algorithms, over seeded workloads of the distributions that matter to the
+ * hull: uniform in a square and in a disk, in convex position (every point on
+ * the hull), on a few lines with many repeated points, in clusters, and on a
+ * grid, and in a disk inside a polygon of --hull-size vertices, so that the
+ * engines can be compared as the size of the hull grows. The queries of the SpatialIndex are timed as well, against a scan of
+ * the set, and the updates of a DynamicHull against computing the hull anew
+ * after every update. Every operation is run over sizes from --min-size to --max-size, in
+ * powers of 10, and the results are written as CSV, and as JSON with --json,
+ * so that they can be kept and compared over time. Run by 'make benchmark'.
+ *
+ * Usage: PointSetBenchmark [--min-size N] [--max-size N] [--workloads a,b,...]
+ *                          [--operations a,b,...] [--repeat N] [--seed N]
+ *                          [--hull-size N] [--csv FILE] [--json FILE]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <memory>
+#include "Point.h"
+#include "PointSet.h"
+#include "HullAlgorithms.h"
+#include "StreamingHull.h"
+#include "SpatialIndex.h"
+#include "DynamicHull.h"
+using namespace std;
+
+static const char* const USAGE = "Usage: PointSetBenchmark [--min-size N] [--max-size N] "
+                                 "[--workloads a,b,...]\n                         "
+                                 "[--operations a,b,...] [--repeat N] [--seed N] "
+                                 "[--hull-size N]\n                         [--csv FILE] [--json FILE]";
+
+/* The coordinates of the workloads lie within [-COORDINATE_RANGE, COORDINATE_RANGE] */
+static const int64_t COORDINATE_RANGE = 1 << 30;
+
+/* The most points a workload in convex position takes: the vertices of a
+ * convex lattice polygon of that many vertices just fit in 32 bit coordinates.
+ * A workload of n points generates 3n / 2, the last n / 2 for the set
+ * operators, so h = n up to 2^21 points. */
+static const int MAX_CONVEX_POINTS = 1 << 22;
+
+/* The default number of points of the disk_circle workload on its hull, and
+ * the fewest it may be given, the vertices of its polygon coming in multiples
+ * of 4 so that the polygon is symmetric around the disk */
+static const int DEFAULT_HULL_SIZE = 1000;
+static const int MIN_HULL_SIZE = 4;
+
+/* Removing in the ORDERED_REMOVAL mode takes quadratic time, so it is only
+ * timed up to this size */
+static const int MAX_ORDERED_REMOVAL_SIZE = 10000;
+
+/* The number of queries timed by the spatial query operations, and the number
+ * of points every query finds in a uniform workload. The scan of the set
+ * takes n steps per query, so it is only timed up to MAX_SCAN_SIZE. */
+static const int SPATIAL_QUERIES = 1000;
+static const double POINTS_PER_QUERY = 8;
+static const int NEAREST_POINTS = 8;
+static const int MAX_SCAN_SIZE = 100000;
+
+/* The number of updates timed by the dynamic hull operations, every one a
+ * point removed and another added, each followed by reading the size of the
+ * hull. Computing the hull anew takes O(n log n) per update, so it is only
+ * timed up to MAX_RECOMPUTE_SIZE. */
+static const int DYNAMIC_UPDATES = 20;
+static const int MAX_RECOMPUTE_SIZE = 100000;
+
+static const char* const WORKLOADS[] = {"uniform_square", "uniform_disk", "convex", "collinear_duplicate",
+                                        "clustered", "grid", "disk_circle"};
+
+static const char* const OPERATIONS[] = {"add", "add_range", "get_index", "remove_unordered", "remove_lazy",
+                                         "remove_ordered", "sort_x", "sort_by_sum", "difference",
+                                         "intersection", "union", "symmetric_difference", "equality",
+                                         "cull", "graham_polar_sort", "graham_scan", "monotone_sort",
+                                         "monotone_scan", "hull_graham", "hull_monotone", "hull_chan",
+                                         "hull_parallel", "hull_stream", "index_build", "index_update",
+                                         "range_query", "range_scan", "nearest_query", "radius_query",
+                                         "dynamic_update", "recompute"};
+
+/**
+ * A seeded generator of random numbers (splitmix64). It is written out here,
+ * instead of using the distributions of the standard library, whose results
+ * differ between implementations, so that a seed gives the same workload
+ * everywhere.
+ */
+class Random
+{
+public:
+	Random(const uint64_t seed): _state(seed){}
+
+	/** Returns the next 64 random bits */
+	uint64_t next()
+	{
+		uint64_t z = (_state += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		return z ^ (z >> 31);
+	}
+
+	/** Returns a random integer in [low, high] */
+	int64_t uniform(const int64_t low, const int64_t high)
+	{
+		return low + (int64_t)(((unsigned __int128)next() * (uint64_t)(high - low + 1)) >> 64);
+	}
+
+private:
+	uint64_t _state;
+};
+
+/** Shuffles the given points, so that no workload is given in an order that
+ * favours some of the operations */
+static void shuffle(Random& random, vector<Point>& points)
+{
+	for(int i = (int)points.size() - 1; i > 0; i--)
+	{
+		swap(points[i], points[random.uniform(0, i)]);
+	}
+}
+
+/** Returns the greatest common divisor of the given non negative numbers */
+static int greatestCommonDivisor(int a, int b)
+{
+	while(b != 0)
+	{
+		int remainder = a % b;
+		a = b;
+		b = remainder;
+	}
+	return a;
+}
+
+/**
+ * Generates n points in convex position: the vertices of a convex lattice
+ * polygon whose edges are the shortest distinct primitive vectors, sorted by
+ * their angles. The polygon takes the vectors of the first quadrant, and
+ * their rotations to the other three, so it closes around its centre. Beyond
+ * MAX_CONVEX_POINTS the rest of the points are spread inside the polygon.
+ */
+static void convexWorkload(Random& random, const int n, vector<Point>& points)
+{
+	const int vertices = min(n, MAX_CONVEX_POINTS);
+	vector< pair<int, int> > edges;
+	for(int sum = 1; (int)edges.size() * 4 < vertices; sum++)
+	{
+		for(int a = sum; a >= 1 and (int)edges.size() * 4 < vertices; a--)
+		{
+			if(greatestCommonDivisor(a, sum - a) == 1)
+			{
+				edges.push_back(make_pair(a, sum - a));
+			}
+		}
+	}
+	sort(edges.begin(), edges.end(), [](const pair<int, int>& e1, const pair<int, int>& e2)
+	{
+		return (int64_t)e1.first * e2.second > (int64_t)e1.second * e2.first;
+	});
+
+	int64_t x = 0;
+	int64_t y = 0;
+	int64_t minX = 0;
+	int64_t maxX = 0;
+	int64_t minY = 0;
+	int64_t maxY = 0;
+	vector< pair<int64_t, int64_t> > polygon;
+	for(int quadrant = 0; quadrant < 4; quadrant++)
+	{
+		for(size_t i = 0; i < edges.size() and (int)polygon.size() < vertices; i++)
+		{
+			int dx = edges[i].first;
+			int dy = edges[i].second;
+			for(int turn = 0; turn < quadrant; turn++)
+			{
+				swap(dx, dy);
+				dx = -dx;
+			}
+			x += dx;
+			y += dy;
+			polygon.push_back(make_pair(x, y));
+			minX = min(minX, x);
+			maxX = max(maxX, x);
+			minY = min(minY, y);
+			maxY = max(maxY, y);
+		}
+	}
+
+	/* The polygon is centred at the origin, and the rest of the points are
+	 * spread in a square well within it */
+	const int64_t centreX = (minX + maxX) / 2;
+	const int64_t centreY = (minY + maxY) / 2;
+	for(size_t i = 0; i < polygon.size(); i++)
+	{
+		points.push_back(Point((int)(polygon[i].first - centreX), (int)(polygon[i].second - centreY)));
+	}
+	const int64_t inside = (maxX - minX) / 6;
+	while((int)points.size() < n)
+	{
+		points.push_back(Point((int)random.uniform(-inside, inside), (int)random.uniform(-inside, inside)));
+	}
+}
+
+/**
+ * Generates n points, the given number of them in convex position: the
+ * vertices of the polygon of convexWorkload, rounded down to a multiple of 4
+ * so that the polygon is symmetric around its centre, and scaled to the
+ * coordinate range. The rest are uniform in a disk around the centre, well
+ * within the polygon. The vertices are shuffled among the middle third of the
+ * points, which the first and the last two thirds share, so that the hull of
+ * either is made of all the vertices and nothing else.
+ */
+static void diskCircleWorkload(Random& random, const int n, const int hullSize, vector<Point>& points)
+{
+	const int third = n / 3;
+	int vertices = min(min(third, hullSize), MAX_CONVEX_POINTS);
+	if(vertices >= MIN_HULL_SIZE)
+	{
+		vertices -= vertices % 4;
+	}
+	vector<Point> polygon;
+	convexWorkload(random, vertices, polygon);
+
+	/* The polygon is centred at the origin exactly, in doubled coordinates,
+	 * and scaled by an integer, which keeps its vertices in convex position */
+	int64_t sumX = 0;
+	int64_t sumY = 0;
+	if(!polygon.empty())
+	{
+		auto xs = minmax_element(polygon.begin(), polygon.end(), [](const Point& p1, const Point& p2)
+		{
+			return p1.getX() < p2.getX();
+		});
+		auto ys = minmax_element(polygon.begin(), polygon.end(), [](const Point& p1, const Point& p2)
+		{
+			return p1.getY() < p2.getY();
+		});
+		sumX = (int64_t)xs.first->getX() + xs.second->getX();
+		sumY = (int64_t)ys.first->getY() + ys.second->getY();
+	}
+	int64_t farthest = 1;
+	for(size_t i = 0; i < polygon.size(); i++)
+	{
+		farthest = max(farthest, max(abs(2 * (int64_t)polygon[i].getX() - sumX),
+		                             abs(2 * (int64_t)polygon[i].getY() - sumY)));
+	}
+	const int64_t scale = max((int64_t)1, COORDINATE_RANGE / farthest);
+	for(size_t i = 0; i < polygon.size(); i++)
+	{
+		polygon[i] = Point((int)((2 * (int64_t)polygon[i].getX() - sumX) * scale),
+		                   (int)((2 * (int64_t)polygon[i].getY() - sumY) * scale));
+	}
+
+	const int64_t radius = farthest * scale / 3;
+	while((int)points.size() < n - vertices)
+	{
+		int64_t x = random.uniform(-radius, radius);
+		int64_t y = random.uniform(-radius, radius);
+		if(x * x + y * y <= radius * radius)
+		{
+			points.push_back(Point((int)x, (int)y));
+		}
+	}
+
+	/* The points of the disk are drawn independently, so only the middle
+	 * third, where the vertices are placed, needs shuffling */
+	points.insert(points.begin() + third, polygon.begin(), polygon.end());
+	vector<Point> middle(points.begin() + third, points.begin() + 2 * third);
+	shuffle(random, middle);
+	copy(middle.begin(), middle.end(), points.begin() + third);
+}
+
+/**
+ * Generates n points of the given workload into the given vector, in random
+ * order, or with hullSize of them on the hull for the disk_circle workload.
+ * Returns false if there is no such workload.
+ */
+static bool generateWorkload(const string& workload, const int n, const int hullSize, const uint64_t seed,
+                             vector<Point>& points)
+{
+	Random random(seed);
+	points.clear();
+	points.reserve(n);
+	const int64_t r = COORDINATE_RANGE;
+	if(workload == "uniform_square")
+	{
+		for(int i = 0; i < n; i++)
+		{
+			points.push_back(Point((int)random.uniform(-r, r), (int)random.uniform(-r, r)));
+		}
+	}
+	else if(workload == "uniform_disk")
+	{
+		while((int)points.size() < n)
+		{
+			int64_t x = random.uniform(-r, r);
+			int64_t y = random.uniform(-r, r);
+			if(x * x + y * y <= r * r)
+			{
+				points.push_back(Point((int)x, (int)y));
+			}
+		}
+	}
+	else if(workload == "convex")
+	{
+		convexWorkload(random, n, points);
+	}
+	else if(workload == "collinear_duplicate")
+	{
+		/* Points on 16 lines in 6 directions, at few enough places along
+		 * every line that many of them repeat, and a quarter of the points
+		 * copied from earlier ones */
+		static const int DIRECTIONS[6][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}, {2, 1}, {1, 2}};
+		const int lines = 16;
+		const int64_t places = max(n / (2 * lines), 1);
+		const int64_t step = r / (2 * places + 1);
+		int64_t offsets[lines][2];
+		for(int line = 0; line < lines; line++)
+		{
+			offsets[line][0] = random.uniform(-r / 4, r / 4);
+			offsets[line][1] = random.uniform(-r / 4, r / 4);
+		}
+		for(int i = 0; i < n; i++)
+		{
+			if(i > 0 and random.uniform(0, 3) == 0)
+			{
+				points.push_back(points[random.uniform(0, i - 1)]);
+				continue;
+			}
+			int line = (int)random.uniform(0, lines - 1);
+			const int* direction = DIRECTIONS[line % 6];
+			int64_t t = random.uniform(-places, places) * step;
+			points.push_back(Point((int)(offsets[line][0] + t * direction[0] / 2),
+			                       (int)(offsets[line][1] + t * direction[1] / 2)));
+		}
+	}
+	else if(workload == "clustered")
+	{
+		/* 16 clusters, whose points are the sums of 4 uniform offsets, so that
+		 * they are denser at the centres */
+		const int clusters = 16;
+		const int64_t spread = r / 64;
+		int64_t centres[clusters][2];
+		for(int cluster = 0; cluster < clusters; cluster++)
+		{
+			centres[cluster][0] = random.uniform(-r / 2, r / 2);
+			centres[cluster][1] = random.uniform(-r / 2, r / 2);
+		}
+		for(int i = 0; i < n; i++)
+		{
+			int cluster = (int)random.uniform(0, clusters - 1);
+			int64_t x = centres[cluster][0];
+			int64_t y = centres[cluster][1];
+			for(int k = 0; k < 4; k++)
+			{
+				x += random.uniform(-spread, spread);
+				y += random.uniform(-spread, spread);
+			}
+			points.push_back(Point((int)x, (int)y));
+		}
+	}
+	else if(workload == "disk_circle")
+	{
+		diskCircleWorkload(random, n, hullSize, points);
+		return true;
+	}
+	else if(workload == "grid")
+	{
+		int side = 1;
+		while((int64_t)side * side < n)
+		{
+			side++;
+		}
+		const int64_t spacing = max((int64_t)1, 2 * r / side);
+		for(int i = 0; i < n; i++)
+		{
+			points.push_back(Point((int)(-r + (i % side) * spacing), (int)(-r + (i / side) * spacing)));
+		}
+	}
+	else
+	{
+		return false;
+	}
+	shuffle(random, points);
+	return true;
+}
+
+/** Orders points by the sum of their coordinates, and secondly by x, so that
+ * sets are sorted by comparisons rather than by the radix sort */
+struct SumOrder
+{
+	bool operator()(const Point& p1, const Point& p2) const
+	{
+		int64_t sum1 = (int64_t)p1.getX() + p1.getY();
+		int64_t sum2 = (int64_t)p2.getX() + p2.getY();
+		return sum1 < sum2 or (sum1 == sum2 and p1.getX() < p2.getX());
+	}
+};
+
+/** A single timed operation over a workload */
+struct Measurement
+{
+	string workload;
+	int n;
+	string operation;
+	int setSize; // The number of distinct points of the workload
+	long long result; // The outcome of the operation, such as the size of the hull
+	double minSeconds;
+	double medianSeconds;
+};
+
+/**
+ * Times the operations over the workloads, keeping every measurement for the
+ * report. Every operation is repeated over a fresh copy of the workload,
+ * prepared outside of the timing, and the minimum and median are kept.
+ */
+class Benchmark
+{
+public:
+	Benchmark(const int repeats, const uint64_t seed, const int hullSize):
+		_repeats(repeats), _seed(seed), _hullSize(hullSize){}
+
+	/** Runs the selected operations over n points of the given workload */
+	bool run(const string& workload, const int n, const vector<string>& operations);
+
+	/** Writes the measurements as CSV, one per line */
+	void writeCsv(ostream& output) const;
+
+	/** Writes the measurements as a JSON object */
+	void writeJson(ostream& output) const;
+
+private:
+	int _repeats;
+	uint64_t _seed;
+	int _hullSize;
+	vector<Measurement> _measurements;
+
+	/** Times the given operation, running the given preparation before
+	 * every repeat, and keeps the measurement */
+	template <typename Prepare, typename Operation>
+	void _measure(const string& workload, const int n, const string& operation, const int setSize,
+	              Prepare prepare, Operation operate);
+};
+
+/** Returns the current time in seconds */
+static double now()
+{
+	return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** Times the given operation and keeps the measurement */
+template <typename Prepare, typename Operation>
+void Benchmark::_measure(const string& workload, const int n, const string& operation, const int setSize,
+                         Prepare prepare, Operation operate)
+{
+	vector<double> seconds;
+	long long result = 0;
+	for(int repeat = 0; repeat < _repeats; repeat++)
+	{
+		prepare();
+		double start = now();
+		result = operate();
+		seconds.push_back(now() - start);
+	}
+	sort(seconds.begin(), seconds.end());
+	Measurement measurement = {workload, n, operation, setSize, result, seconds[0],
+	                           seconds[seconds.size() / 2]};
+	_measurements.push_back(measurement);
+}
+
+/**
+ * Runs the selected operations over n points of the given workload. The set
+ * operators are run between the set of the first n points and the set of the
+ * n points after the first n / 2, so that half of their points are shared.
+ */
+bool Benchmark::run(const string& workload, const int n, const vector<string>& operations)
+{
+	vector<Point> points;
+	if(!generateWorkload(workload, n + n / 2, _hullSize, _seed, points))
+	{
+		return false;
+	}
+	const Point* first = points.data();
+	PointSet base;
+	base.addRange(first, first + n);
+	PointSet other;
+	other.addRange(first + n / 2, first + n + n / 2);
+	const int setSize = base.size();
+	PointSet work;
+	const auto copyBase = [&](){ work = base; };
+	const auto nothing = [](){};
+
+	/* The spatial queries are centered on points of the other set, half of
+	 * them in the base set, and reach as far as takes POINTS_PER_QUERY points
+	 * of a uniform workload */
+	const int queries = min(SPATIAL_QUERIES, other.size());
+	const int64_t reach = min(COORDINATE_RANGE, (int64_t)(COORDINATE_RANGE * sqrt(POINTS_PER_QUERY / max(n, 1))));
+	vector<Point> centers(other.getPoints(), other.getPoints() + queries);
+	vector<Point> lows;
+	vector<Point> highs;
+	for(int j = 0; j < queries; j++)
+	{
+		lows.push_back(Point((int)max(centers[j].getX() - reach, (int64_t)INT32_MIN),
+		                     (int)max(centers[j].getY() - reach, (int64_t)INT32_MIN)));
+		highs.push_back(Point((int)min(centers[j].getX() + reach, (int64_t)INT32_MAX),
+		                      (int)min(centers[j].getY() + reach, (int64_t)INT32_MAX)));
+	}
+	vector<Point> found;
+	vector<int> offsets;
+
+	for(size_t i = 0; i < operations.size(); i++)
+	{
+		const string& operation = operations[i];
+		if(operation == "add")
+		{
+			_measure(workload, n, operation, setSize, [&](){ work = PointSet(); }, [&]()
+			{
+				for(int j = 0; j < n; j++)
+				{
+					work.add(first[j]);
+				}
+				return (long long)work.size();
+			});
+		}
+		else if(operation == "add_range")
+		{
+			_measure(workload, n, operation, setSize, [&](){ work = PointSet(); }, [&]()
+			{
+				return (long long)work.addRange(first, first + n);
+			});
+		}
+		else if(operation == "get_index")
+		{
+			_measure(workload, n, operation, setSize, nothing, [&]()
+			{
+				long long found = 0;
+				for(int j = n / 2; j < n + n / 2; j++)
+				{
+					found += (base.getIndex(first[j]) != POINT_NOT_FOUND);
+				}
+				return found;
+			});
+		}
+		else if(operation == "remove_unordered" or operation == "remove_lazy" or
+		        (operation == "remove_ordered" and n <= MAX_ORDERED_REMOVAL_SIZE))
+		{
+			/* Removing every other point. The lazy removals are compacted by
+			 * the access that follows them, which is timed as well */
+			RemovalMode mode = (operation == "remove_unordered") ? UNORDERED_REMOVAL :
+			                   (operation == "remove_lazy") ? LAZY_REMOVAL : ORDERED_REMOVAL;
+			_measure(workload, n, operation, setSize, [&](){ work = base; work.setRemovalMode(mode); },
+			         [&]()
+			{
+				long long removed = 0;
+				for(int j = 0; j < n; j += 2)
+				{
+					removed += work.remove(first[j]);
+				}
+				work.getPoints();
+				return removed;
+			});
+		}
+		else if(operation == "sort_x")
+		{
+			_measure(workload, n, operation, setSize, copyBase, [&]()
+			{
+				work.sortSet(XCoordinateOrder());
+				return (long long)work.size();
+			});
+		}
+		else if(operation == "sort_by_sum")
+		{
+			_measure(workload, n, operation, setSize, copyBase, [&]()
+			{
+				work.sortSet(SumOrder());
+				return (long long)work.size();
+			});
+		}
+		else if(operation == "difference")
+		{
+			_measure(workload, n, operation, setSize, nothing, [&](){ return (long long)(base - other).size(); });
+		}
+		else if(operation == "intersection")
+		{
+			_measure(workload, n, operation, setSize, nothing, [&](){ return (long long)(base & other).size(); });
+		}
+		else if(operation == "union")
+		{
+			_measure(workload, n, operation, setSize, nothing, [&](){ return (long long)(base | other).size(); });
+		}
+		else if(operation == "symmetric_difference")
+		{
+			_measure(workload, n, operation, setSize, nothing, [&](){ return (long long)(base ^ other).size(); });
+		}
+		else if(operation == "equality")
+		{
+			/* Comparing the set with a copy in another order, which has the same
+			 * fingerprint, so that the points are compared one by one */
+			PointSet reordered(base);
+			reordered.sortSet(XCoordinateOrder());
+			_measure(workload, n, operation, setSize, nothing, [&](){ return (long long)(base == reordered); });
+		}
+		else if(operation == "cull")
+		{
+			_measure(workload, n, operation, setSize, copyBase, [&]()
+			{
+				return (long long)cullInteriorPoints(work);
+			});
+		}
+		else if(operation == "graham_polar_sort")
+		{
+			_measure(workload, n, operation, setSize, copyBase, [&]()
+			{
+				const Point* min = work.getMinimum(YCoordinateOrder());
+				if(min != nullptr)
+				{
+					work.sortByKey(PolarAngleKeyFunction(*min));
+				}
+				return (long long)work.size();
+			});
+		}
+		else if(operation == "graham_scan")
+		{
+			_measure(workload, n, operation, setSize, [&]()
+			{
+				work = base;
+				const Point* min = work.getMinimum(YCoordinateOrder());
+				if(min != nullptr)
+				{
+					work.sortByKey(PolarAngleKeyFunction(*min));
+				}
+			}, [&](){ return (long long)grahmScanSort(work); });
+		}
+		else if(operation == "monotone_sort")
+		{
+			_measure(workload, n, operation, setSize, copyBase, [&]()
+			{
+				work.sortSet(XCoordinateOrder());
+				return (long long)work.size();
+			});
+		}
+		else if(operation == "monotone_scan")
+		{
+			_measure(workload, n, operation, setSize, [&](){ work = base; work.sortSet(XCoordinateOrder()); },
+			         [&](){ return (long long)monotoneChainSort(work); });
+		}
+		else if(operation == "hull_graham" or operation == "hull_monotone" or operation == "hull_chan" or
+		        operation == "hull_parallel")
+		{
+			HullEngine engine = (operation == "hull_graham") ? GRAHAM_SCAN :
+			                    (operation == "hull_chan") ? CHAN_ALGORITHM : MONOTONE_CHAIN;
+			int threads = (operation == "hull_parallel") ? max(2, (int)thread::hardware_concurrency()) : 1;
+			_measure(workload, n, operation, setSize, copyBase, [&]()
+			{
+				computeHull(work, engine, threads);
+				return (long long)work.size();
+			});
+		}
+		else if(operation == "hull_stream")
+		{
+			_measure(workload, n, operation, setSize, nothing, [&]()
+			{
+				StreamingHull hull;
+				hull.add(first, n);
+				return (long long)hull.size();
+			});
+		}
+		else if(operation == "index_build")
+		{
+			_measure(workload, n, operation, setSize, nothing, [&]()
+			{
+				SpatialIndex index(base);
+				return (long long)index.size();
+			});
+		}
+		else if(operation == "index_update")
+		{
+			/* Removing every other point and adding it back, with the index
+			 * following the set */
+			unique_ptr<SpatialIndex> index;
+			_measure(workload, n, operation, setSize, [&]()
+			{
+				index.reset();
+				work = base;
+				work.setRemovalMode(UNORDERED_REMOVAL);
+				index.reset(new SpatialIndex(work));
+			}, [&]()
+			{
+				for(int j = 0; j < n; j += 2)
+				{
+					work.remove(first[j]);
+				}
+				for(int j = 0; j < n; j += 2)
+				{
+					work.add(first[j]);
+				}
+				return (long long)index -> size();
+			});
+			index.reset();
+		}
+		else if(operation == "dynamic_update" or (operation == "recompute" and n <= MAX_RECOMPUTE_SIZE))
+		{
+			/* Replacing the first points of the set by points of the other
+			 * set, and reading the size of the hull after every update, from
+			 * the dynamic hull or from a hull computed anew */
+			const int updates = min(DYNAMIC_UPDATES, n / 2);
+			unique_ptr<DynamicHull> hull;
+			_measure(workload, n, operation, setSize, [&]()
+			{
+				hull.reset();
+				work = base;
+				work.setRemovalMode(UNORDERED_REMOVAL);
+				if(operation == "dynamic_update")
+				{
+					hull.reset(new DynamicHull(work));
+				}
+			}, [&]()
+			{
+				long long vertices = 0;
+				for(int j = 0; j < updates; j++)
+				{
+					work.remove(first[j]);
+					work.add(first[n + j]);
+					if(hull)
+					{
+						vertices += hull -> size();
+					}
+					else
+					{
+						PointSet recomputed(work);
+						computeHull(recomputed, MONOTONE_CHAIN);
+						vertices += recomputed.size();
+					}
+				}
+				return vertices;
+			});
+			hull.reset();
+		}
+		else if(operation == "range_query" or operation == "nearest_query" or operation == "radius_query")
+		{
+			SpatialIndex index(base);
+			_measure(workload, n, operation, setSize, nothing, [&]()
+			{
+				found.clear();
+				offsets.clear();
+				if(operation == "range_query")
+				{
+					index.pointsInRectangles(lows.data(), highs.data(), queries, found, offsets);
+				}
+				else if(operation == "nearest_query")
+				{
+					index.nearestPoints(centers.data(), queries, NEAREST_POINTS, found);
+				}
+				else
+				{
+					index.pointsInRadius(centers.data(), queries, reach, found, offsets);
+				}
+				return (long long)found.size();
+			});
+		}
+		else if(operation == "range_scan" and n <= MAX_SCAN_SIZE)
+		{
+			_measure(workload, n, operation, setSize, nothing, [&]()
+			{
+				const Point* setPoints = base.getPoints();
+				long long inside = 0;
+				for(int q = 0; q < queries; q++)
+				{
+					for(int j = 0; j < setSize; j++)
+					{
+						inside += setPoints[j].getX() >= lows[q].getX() and
+						          setPoints[j].getX() <= highs[q].getX() and
+						          setPoints[j].getY() >= lows[q].getY() and
+						          setPoints[j].getY() <= highs[q].getY();
+					}
+				}
+				return inside;
+			});
+		}
+	}
+	return true;
+}
+
+/** Writes the measurements as CSV, with a header line */
+void Benchmark::writeCsv(ostream& output) const
+{
+	output << "workload,n,operation,set_size,result,repeats,min_seconds,median_seconds,median_ns_per_point\n";
+	output.precision(9);
+	for(size_t i = 0; i < _measurements.size(); i++)
+	{
+		const Measurement& m = _measurements[i];
+		output << m.workload << "," << m.n << "," << m.operation << "," << m.setSize << "," << m.result
+		       << "," << _repeats << "," << m.minSeconds << "," << m.medianSeconds << ","
+		       << m.medianSeconds * 1e9 / m.n << "\n";
+	}
+}
+
+/** Writes the measurements as a JSON object, holding the seed and the number
+ * of repeats along with the results */
+void Benchmark::writeJson(ostream& output) const
+{
+	output.precision(9);
+	output << "{\n  \"seed\": " << _seed << ",\n  \"repeats\": " << _repeats << ",\n  \"results\": [";
+	for(size_t i = 0; i < _measurements.size(); i++)
+	{
+		const Measurement& m = _measurements[i];
+		output << (i == 0 ? "\n" : ",\n") << "    {\"workload\": \"" << m.workload << "\", \"n\": " << m.n
+		       << ", \"operation\": \"" << m.operation << "\", \"set_size\": " << m.setSize
+		       << ", \"result\": " << m.result << ", \"min_seconds\": " << m.minSeconds
+		       << ", \"median_seconds\": " << m.medianSeconds << ", \"median_ns_per_point\": "
+		       << m.medianSeconds * 1e9 / m.n << "}";
+	}
+	output << "\n  ]\n}\n";
+}
+
+/** Splits the given comma separated list */
+static vector<string> splitList(const string& list)
+{
+	vector<string> items;
+	stringstream stream(list);
+	string item;
+	while(getline(stream, item, ','))
+	{
+		items.push_back(item);
+	}
+	return items;
+}
+
+/**
+ * Main function - runs the benchmark and writes its results. Returns 1 if the
+ * arguments were invalid or a result file couldn't be written.
+ */
+int main(int argc, char* argv[])
+{
+	long long minSize = 1000;
+	long long maxSize = 1000000;
+	int repeats = 3;
+	uint64_t seed = 1;
+	int hullSize = DEFAULT_HULL_SIZE;
+	vector<string> workloads(WORKLOADS, WORKLOADS + sizeof(WORKLOADS) / sizeof(WORKLOADS[0]));
+	vector<string> operations(OPERATIONS, OPERATIONS + sizeof(OPERATIONS) / sizeof(OPERATIONS[0]));
+	const char* csvFile = nullptr;
+	const char* jsonFile = nullptr;
+	for(int i = 1; i < argc; i++)
+	{
+		string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+		if(argument == "--min-size" and hasValue and (minSize = atoll(argv[i + 1])) > 0)
+		{
+			i++;
+		}
+		else if(argument == "--max-size" and hasValue and (maxSize = atoll(argv[i + 1])) > 0 and
+		        maxSize <= 100000000)
+		{
+			i++;
+		}
+		else if(argument == "--repeat" and hasValue and (repeats = atoi(argv[i + 1])) > 0)
+		{
+			i++;
+		}
+		else if(argument == "--seed" and hasValue)
+		{
+			seed = strtoull(argv[++i], nullptr, 10);
+		}
+		else if(argument == "--hull-size" and hasValue and (hullSize = atoi(argv[i + 1])) >= MIN_HULL_SIZE)
+		{
+			i++;
+		}
+		else if(argument == "--workloads" and hasValue)
+		{
+			workloads = splitList(argv[++i]);
+		}
+		else if(argument == "--operations" and hasValue)
+		{
+			operations = splitList(argv[++i]);
+		}
+		else if(argument == "--csv" and hasValue)
+		{
+			csvFile = argv[++i];
+		}
+		else if(argument == "--json" and hasValue)
+		{
+			jsonFile = argv[++i];
+		}
+		else
+		{
+			cerr << USAGE << endl;
+			return 1;
+		}
+	}
+
+	for(size_t i = 0; i < operations.size(); i++)
+	{
+		if(find(OPERATIONS, OPERATIONS + sizeof(OPERATIONS) / sizeof(OPERATIONS[0]), operations[i]) ==
+		   OPERATIONS + sizeof(OPERATIONS) / sizeof(OPERATIONS[0]))
+		{
+			cerr << "Unknown operation " << operations[i] << endl;
+			return 1;
+		}
+	}
+
+	Benchmark benchmark(repeats, seed, hullSize);
+	for(size_t w = 0; w < workloads.size(); w++)
+	{
+		for(long long n = minSize; n <= maxSize; n *= 10)
+		{
+			cerr << "Running " << workloads[w] << " with " << n << " points" << endl;
+			if(!benchmark.run(workloads[w], (int)n, operations))
+			{
+				cerr << "Unknown workload " << workloads[w] << endl;
+				return 1;
+			}
+		}
+	}
+
+	if(csvFile == nullptr)
+	{
+		benchmark.writeCsv(cout);
+	}
+	else
+	{
+		ofstream csv(csvFile);
+		benchmark.writeCsv(csv);
+		if(!csv)
+		{
+			cerr << "Cannot write " << csvFile << endl;
+			return 1;
+		}
+	}
+	if(jsonFile != nullptr)
+	{
+		ofstream json(jsonFile);
+		benchmark.writeJson(json);
+		if(!json)
+		{
+			cerr << "Cannot write " << jsonFile << endl;
+			return 1;
+		}
+	}
+	return 0;
+}
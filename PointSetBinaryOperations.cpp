@@ -96,6 +96,54 @@ int main()
 	cout << "Here is the result of set1 & set4:" << endl << (set1 & set4).toString() << endl;
 
 
+	// Using '|' and '^' operators
+	cout << "Here is the result of set1 | set3:" << endl << (set1 | set3).toString() << endl;
+	cout << "Here is the result of set3 | set4:" << endl << (set3 | set4).toString() << endl;
+	cout << "Here is the result of set1 ^ set3:" << endl << (set1 ^ set3).toString() << endl;
+	cout << "Here is the result of set1 ^ set1:" << endl << (set1 ^ set1).toString() << endl;
+	cout << "Is (set1 | set3) - (set1 & set3) equal to set1 ^ set3? "
+	     << (((set1 | set3) - (set1 & set3)) == (set1 ^ set3)) << endl;
+
+
+	// Adding ranges of points at once
+	const int coordinates[] = {1, 13, 3, 14, 1, 13, 4, 13, 3, 14};
+	PointSet set5(coordinates, 5);
+	cout << "Set 5, built from a buffer with repeated points, contains:" << endl
+	     << set5.toString() << endl;
+
+	const Point range[] = {p9, p10, p1, p9};
+	cout << "Adding the range 8,8 10,10 1,13 8,8 to set 5 added "
+	     << set5.addRange(range, range + 4) << " points:" << endl << set5.toString() << endl;
+
+	PointSet set8(set5);
+	set8.shrinkToFit();
+	cout << "Adding its own points to a trimmed copy of set 5 added "
+	     << set8.addRange(set8.getPoints(), set8.getPoints() + set8.size()) << " points:" << endl
+	     << set8.toString() << endl;
+	cout << "Is it still equal to set 5? " << (set8 == set5) << endl;
+
+	set5.assign(range, range + 2);
+	cout << "After assigning the range 8,8 10,10 to set 5, it contains:" << endl
+	     << set5.toString() << endl;
+	cout << "Is set 5 equal to (set 1 ^ set 3) - set 2? " << (set5 == ((set1 ^ set3) - set2)) << endl;
+
+
+	// Removing points in the unordered and lazy modes
+	PointSet set6(set1);
+	set6.setRemovalMode(UNORDERED_REMOVAL);
+	set6.remove(p2);
+	cout << "After removing 3,14 from a copy of set 1 in the unordered mode, it contains:" << endl
+	     << set6.toString() << endl;
+
+	PointSet set7(set1);
+	set7.setRemovalMode(LAZY_REMOVAL);
+	set7.remove(p2);
+	set7.remove(p5);
+	cout << "After removing 3,14 and 4,8 from a copy of set 1 in the lazy mode, it has "
+	     << set7.size() << " points, and point 1 is " << set7[1] -> toString() << endl
+	     << set7.toString() << endl;
+
+
 	//Using the assignment operator
 	cout << "This is the current content of set 1" << endl << set1.toString() << endl;
 	cout << "This is the current content of set 2" << endl << set2.toString() << endl;
@@ -0,0 +1,138 @@
+//PointSetCoordinateTypes.cpp
+
+/**
+ * This file tests the point sets of the coordinate types other than int:
+ * int16_t, int64_t and double. Every type is put through the same set
+ * operations and sorts, followed by the checks particular to it, such as the
+ * exactness of the turns of 64 bit coordinates. The text of the points of all
+ * types is checked against the text written by a stream.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include "Point.h"
+#include "PointSet.h"
+#include "HullAlgorithms.h"
+#include "TestUtils.h"
+using namespace std;
+
+/** Returns true iff the points of the given set are sorted by the given order */
+template <typename Coordinate, typename Order>
+static bool isSortedBy(const BasicPointSet<Coordinate>& set, const Order& order)
+{
+	return is_sorted(set.getPoints(), set.getPoints() + set.size(), order);
+}
+
+/**
+ * Runs the set operations and the sorts over sets of the given coordinate
+ * type. The points are scattered by the given scale, and more of them than
+ * the sorts take by comparisons.
+ */
+template <typename Coordinate>
+static void checkSets(const string& name, const Coordinate scale)
+{
+	const int n = 1000;
+	BasicPointSet<Coordinate> a;
+	BasicPointSet<Coordinate> b;
+	for(int i = 0; i < n; i++)
+	{
+		Coordinate x = (Coordinate)((i * 37) % n - n / 2) * scale;
+		Coordinate y = (Coordinate)((i * 91) % n - n / 2) * scale;
+		a.add(BasicPoint<Coordinate>(x, y));
+		if(i % 2 == 0)
+		{
+			b.add(BasicPoint<Coordinate>(x, y));
+		}
+	}
+	check(name + " set holds the points", a.size() == n and b.size() == n / 2);
+	check(name + " set drops duplicates", !a.add(*a.getPoints()) and a.size() == n);
+	check(name + " a - b", (a - b).size() == n / 2);
+	check(name + " a & b", (a & b) == b);
+	check(name + " a | b", (a | b) == a);
+	check(name + " a ^ b", (a ^ b) == (a - b));
+
+	BasicPointSet<Coordinate> sorted(a);
+	sorted.sortSet(XCoordinateOrder());
+	check(name + " sorting by XCoordinateOrder", isSortedBy(sorted, XCoordinateOrder()));
+	check(name + " sorting keeps the points", sorted == a);
+	sorted.sortSet(yCoordinateComparator<Coordinate>);
+	check(name + " sorting by yCoordinateComparator", isSortedBy(sorted, YCoordinateOrder()));
+	check(name + " sorted set finds its points",
+	      sorted.getIndex(sorted.getPoints()[n / 3]) == n / 3);
+	check(name + " minimum by YCoordinateOrder",
+	      *sorted.getMinimum(YCoordinateOrder()) == sorted.getPoints()[0]);
+
+	BasicPoint<Coordinate> removed = *a[n / 2];
+	a.remove(removed);
+	check(name + " removing a point", a.size() == n - 1 and a.getIndex(removed) == POINT_NOT_FOUND);
+	check(name + " sets told apart", a != sorted);
+}
+
+/**
+ * Checks that the given point is written as a stream writes its coordinates,
+ * floating ones with as many digits as it takes to read them back, both alone
+ * and in a set
+ */
+template <typename Coordinate>
+static void checkText(const string& name, const Coordinate x, const Coordinate y)
+{
+	ostringstream expected;
+	expected.precision(numeric_limits<Coordinate>::max_digits10);
+	expected << +x << "," << +y;
+	BasicPoint<Coordinate> point(x, y);
+	BasicPointSet<Coordinate> set;
+	set.add(point);
+	check(name + " point " + expected.str() + " written as text", point.toString() == expected.str() and
+	      set.toString() == expected.str() + "\n");
+}
+
+int main()
+{
+	checkSets<int16_t>("int16_t", 30);
+	checkSets<int64_t>("int64_t", (int64_t)1 << 50);
+	checkSets<double>("double", 0.001);
+
+	check("int16_t points take 4 bytes", sizeof(BasicPoint<int16_t>) == 4);
+
+	BasicPointSet<int64_t> wide;
+	for(int64_t i = 0; i < 100; i++)
+	{
+		wide.add(BasicPoint<int64_t>(i << 32, 0));
+	}
+	check("int64_t points differing in the high bits alone", wide.size() == 100);
+
+	const int64_t lowest = numeric_limits<int64_t>::min();
+	const int64_t highest = numeric_limits<int64_t>::max();
+	BasicPoint<int64_t> corner(lowest, lowest);
+	BasicPoint<int64_t> opposite(highest, highest);
+	BasicPoint<int64_t> below(highest, highest - 1);
+	BasicPoint<int64_t> above(highest - 1, highest);
+	BasicPoint<int64_t> middle(-1, -1);
+	check("int64_t right turn at the limits", getTurnDirection(&corner, &opposite, &below) < 0);
+	check("int64_t left turn at the limits", getTurnDirection(&corner, &opposite, &above) > 0);
+	check("int64_t collinear at the limits", getTurnDirection(&corner, &opposite, &middle) == 0);
+
+	BasicPoint<double> origin(0.0, 0.0);
+	BasicPoint<double> right(1.5, 0.0);
+	BasicPoint<double> up(1.5, 0.25);
+	check("double left turn", getTurnDirection(&origin, &right, &up) > 0);
+
+	BasicPointSet<double> zeros;
+	zeros.add(origin);
+	check("double -0.0 equals 0.0", !zeros.add(BasicPoint<double>(-0.0, 0.0)) and
+	      zeros.getIndex(BasicPoint<double>(0.0, -0.0)) == 0);
+
+	checkText<int16_t>("int16_t", numeric_limits<int16_t>::min(), numeric_limits<int16_t>::max());
+	checkText<int32_t>("int32_t", numeric_limits<int32_t>::min(), 0);
+	checkText<int32_t>("int32_t", -7, 1000000009);
+	checkText<int64_t>("int64_t", lowest, highest);
+	checkText<double>("double", -0.0, 0.1);
+	checkText<double>("double", -numeric_limits<double>::min(), numeric_limits<double>::max());
+	checkText<double>("double", 1e21, -123.5);
+
+	cout << (passed ? "All coordinate type checks passed" : "Some coordinate type checks failed") << endl;
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+//PointSetDynamicHull.cpp
+
+/**
+ * This file tests the DynamicHull of a set, against the hull computed from
+ * scratch by computeHull. The set is changed by random steps of every
+ * operation that the hull follows: add, remove in every removal mode,
+ * addRange, trim, assignment and clear, and the hull is checked after each
+ * step. The points are drawn from a small grid, so that they are often
+ * repeated and collinear, and from the limits of the coordinates.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <climits>
+#include "Point.h"
+#include "PointSet.h"
+#include "HullAlgorithms.h"
+#include "DynamicHull.h"
+#include "TestUtils.h"
+using namespace std;
+
+/** Returns a random point of the grid [0, size) x [0, size), or one of the
+ * corners of the coordinates now and then */
+static Point nextPoint(const int size)
+{
+	if(nextNumber(0, 50) == 0)
+	{
+		return Point(nextNumber(0, 1) ? INT_MAX : INT_MIN, nextNumber(0, 1) ? INT_MAX : INT_MIN);
+	}
+	return Point(nextNumber(0, size - 1), nextNumber(0, size - 1));
+}
+
+/** Returns true iff the points of the given set are sorted by the x
+ * coordinate, and secondly by the y coordinate */
+static bool isSorted(const PointSet& set)
+{
+	return is_sorted(set.getPoints(), set.getPoints() + set.size(), [](const Point& p1, const Point& p2)
+	{
+		return p1.getX() < p2.getX() or (p1.getX() == p2.getX() and p1.getY() < p2.getY());
+	});
+}
+
+/**
+ * Runs the given number of random steps over a set in the given removal mode,
+ * with points from a grid of the given size, and checks the dynamic hull
+ * against computeHull after every step. Returns true iff all steps matched.
+ */
+static bool checkSteps(const RemovalMode mode, const int steps, const int gridSize)
+{
+	PointSet set;
+	set.setRemovalMode(mode);
+	DynamicHull hull(set);
+	bool matched = true;
+	for(int step = 0; matched and step < steps; step++)
+	{
+		int action = nextNumber(0, 99);
+		if(action < 45 or set.size() == 0)
+		{
+			set.add(nextPoint(gridSize));
+		}
+		else if(action < 85)
+		{
+			set.remove(*set[nextNumber(0, set.size() - 1)]);
+		}
+		else if(action < 92)
+		{
+			vector<Point> range;
+			for(int i = nextNumber(0, 20); i > 0; i--)
+			{
+				range.push_back(nextPoint(gridSize));
+			}
+			set.addRange(range.data(), range.data() + range.size());
+		}
+		else if(action < 97)
+		{
+			set.trim(nextNumber(0, min(set.size(), 10)));
+		}
+		else if(action < 99)
+		{
+			PointSet other;
+			for(int i = nextNumber(0, 30); i > 0; i--)
+			{
+				other.add(nextPoint(gridSize));
+			}
+			set = other;
+		}
+		else
+		{
+			set.clear();
+		}
+
+		PointSet expected(set);
+		computeHull(expected, MONOTONE_CHAIN);
+		PointSet found;
+		hull.getHull(found);
+		matched = found == expected and hull.size() == expected.size() and isSorted(found);
+	}
+	return matched;
+}
+
+/**
+ * Main function - runs the random steps in every removal mode, over a grid
+ * small enough for many repeated and collinear points, and a larger one
+ */
+int main()
+{
+	const RemovalMode modes[] = {ORDERED_REMOVAL, UNORDERED_REMOVAL, LAZY_REMOVAL};
+	const char* const names[] = {"ordered", "unordered", "lazy"};
+	for(int mode = 0; mode < 3; mode++)
+	{
+		check(string("Small grid steps in the ") + names[mode] + " removal mode",
+		      checkSteps(modes[mode], 3000, 8));
+		check(string("Large grid steps in the ") + names[mode] + " removal mode",
+		      checkSteps(modes[mode], 3000, 1000));
+	}
+
+	PointSet line;
+	DynamicHull lineHull(line);
+	for(int i = 0; i < 100; i++)
+	{
+		line.add(Point(5, nextNumber(-1000, 1000)));
+	}
+	PointSet expected(line);
+	computeHull(expected, MONOTONE_CHAIN);
+	PointSet found;
+	lineHull.getHull(found);
+	check("Vertical line", found == expected);
+
+	cout << (passed ? "All dynamic hull checks passed" : "Some dynamic hull checks failed") << endl;
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+// PointSetObserver.h
+#ifndef POINT_SET_OBSERVER_H
+#define POINT_SET_OBSERVER_H
+
+#include "Point.h"
+
+template <typename Coordinate>
+class BasicPointSet;
+
+/**
+ * The interface of objects that follow the contents of a BasicPointSet, such as
+ * structures built over its points. An observer is attached to a set with
+ * BasicPointSet::addObserver, and is then notified of every change to the
+ * points the set holds. Changes to the order of the points alone are not
+ * notified. An observer must be removed from the set before either of them is
+ * destroyed.
+ */
+template <typename Coordinate>
+class BasicPointSetObserver
+{
+public:
+
+	/**
+	 * Destructor
+	 */
+	virtual ~BasicPointSetObserver(){}
+
+	/**
+	 * Called after the given point was added to the observed set
+	 */
+	virtual void pointAdded(const BasicPoint<Coordinate>& point) = 0;
+
+	/**
+	 * Called after the given point was removed from the observed set
+	 */
+	virtual void pointRemoved(const BasicPoint<Coordinate>& point) = 0;
+
+	/**
+	 * Called after all the points of the observed set were replaced at once,
+	 * e.g. by an assignment. The given set is the observed set, holding its
+	 * new points.
+	 */
+	virtual void setReset(const BasicPointSet<Coordinate>& set) = 0;
+};
+
+/** The observers of the sets used by the hull algorithms */
+typedef BasicPointSetObserver<int32_t> PointSetObserver;
+
+#endif
@@ -0,0 +1,268 @@
+//PointSetSimdKernels.cpp
+
+/**
+ * This file tests the kernels of SimdKernels at every instruction set the
+ * running CPU supports. findExtremes is checked against a scan of the points,
+ * and orientBlock against getTurnDirection, over points spread uniformly,
+ * over the whole range of the coordinates, close to the line of the turns
+ * and at the limits of the coordinates. The arrays have lengths that are not
+ * multiples of the width of the vectors, so that the remainders of the
+ * vectorized loops are checked as well.
+ */
+
+#include <iostream>
+#include <vector>
+#include <climits>
+#include <cstdlib>
+#include "Point.h"
+#include "HullAlgorithms.h"
+#include "SimdKernels.h"
+#include "TestUtils.h"
+using namespace std;
+
+/** Returns a random point with coordinates in [low, high] */
+static Point randomPoint(const long long low, const long long high)
+{
+	return Point((int)nextNumber(low, high), (int)nextNumber(low, high));
+}
+
+/** Returns a random point whose coordinates are both limits */
+static Point limitPoint()
+{
+	return Point(LIMITS[nextNumber(0, LIMITS_COUNT - 1)], LIMITS[nextNumber(0, LIMITS_COUNT - 1)]);
+}
+
+/** Returns true iff the given coordinates fit in a point */
+static bool fits(const long long x, const long long y)
+{
+	return x >= INT_MIN and x <= INT_MAX and y >= INT_MIN and y <= INT_MAX;
+}
+
+/**
+ * Returns a line from a to b, both anywhere within the coordinates, whose
+ * direction b - a is a primitive vector of up to 2^30 on either axis
+ */
+static void nearLine(Point& a, Point& b)
+{
+	while(true)
+	{
+		const long long reach = 1LL << nextNumber(8, 30);
+		long long x = nextNumber(-reach, reach);
+		long long y = nextNumber(-reach, reach);
+		long long gcd = x;
+		for(long long other = y; other != 0; )
+		{
+			long long remainder = gcd % other;
+			gcd = other;
+			other = remainder;
+		}
+		a = randomPoint(INT_MIN, INT_MAX);
+		if((gcd == 1 or gcd == -1) and fits(a.getX() + x, a.getY() + y))
+		{
+			b = Point((int)(a.getX() + x), (int)(a.getY() + y));
+			return;
+		}
+	}
+}
+
+/**
+ * Returns a point p = a + k * v + t * (b - a) for a random k of -2 to 2, where
+ * the cross product of b - a and v is 1, so that the turn of a, b and p is k
+ * exactly, though p may be as far from a as the coordinates allow and the
+ * products of the turn too large to be exact in floating point
+ */
+static Point nearLinePoint(const Point& a, const Point& b)
+{
+	const long long ux = (long long)b.getX() - a.getX();
+	const long long uy = (long long)b.getY() - a.getY();
+
+	/* The extended Euclidean algorithm, for ux * vy - uy * vx = 1 */
+	long long oldR = ux, r = uy, oldS = 1, s = 0, oldT = 0, t = 1;
+	while(r != 0)
+	{
+		long long quotient = oldR / r;
+		long long next = oldR - quotient * r;
+		oldR = r;
+		r = next;
+		next = oldS - quotient * s;
+		oldS = s;
+		s = next;
+		next = oldT - quotient * t;
+		oldT = t;
+		t = next;
+	}
+	const long long vx = -oldT * oldR;
+	const long long vy = oldS * oldR;
+
+	const long long steps = (1LL << 32) / max(abs(ux), abs(uy));
+	while(true)
+	{
+		long long k = nextNumber(-2, 2);
+		long long step = nextNumber(-steps, steps);
+		long long x = a.getX() + k * vx + step * ux;
+		long long y = a.getY() + k * vy + step * uy;
+		if(fits(x, y))
+		{
+			return Point((int)x, (int)y);
+		}
+	}
+}
+
+/** Finds the extremes of the given points by a scan, taking the first of the
+ * points attaining the same value */
+static ExtremeIndexes scanExtremes(const vector<Point>& points)
+{
+	ExtremeIndexes result = {0, 0, 0, 0, 0, 0, 0, 0};
+	for(int i = 1; i < (int)points.size(); i++)
+	{
+		long long x = points[i].getX();
+		long long y = points[i].getY();
+		const Point& minX = points[result.minX];
+		const Point& maxX = points[result.maxX];
+		const Point& minY = points[result.minY];
+		const Point& maxY = points[result.maxY];
+		const Point& minSum = points[result.minSum];
+		const Point& maxSum = points[result.maxSum];
+		const Point& minDifference = points[result.minDifference];
+		const Point& maxDifference = points[result.maxDifference];
+		result.minX = (x < minX.getX()) ? i : result.minX;
+		result.maxX = (x > maxX.getX()) ? i : result.maxX;
+		result.minY = (y < minY.getY()) ? i : result.minY;
+		result.maxY = (y > maxY.getY()) ? i : result.maxY;
+		result.minSum = (x + y < (long long)minSum.getX() + minSum.getY()) ? i : result.minSum;
+		result.maxSum = (x + y > (long long)maxSum.getX() + maxSum.getY()) ? i : result.maxSum;
+		result.minDifference = (x - y < (long long)minDifference.getX() - minDifference.getY()) ?
+		                       i : result.minDifference;
+		result.maxDifference = (x - y > (long long)maxDifference.getX() - maxDifference.getY()) ?
+		                       i : result.maxDifference;
+	}
+	return result;
+}
+
+/** Returns true iff the given extremes are the same */
+static bool sameExtremes(const ExtremeIndexes& e1, const ExtremeIndexes& e2)
+{
+	return e1.minX == e2.minX and e1.maxX == e2.maxX and e1.minY == e2.minY and e1.maxY == e2.maxY and
+	       e1.minSum == e2.minSum and e1.maxSum == e2.maxSum and
+	       e1.minDifference == e2.minDifference and e1.maxDifference == e2.maxDifference;
+}
+
+/** Returns the sign of the given number */
+static int sign(const int number)
+{
+	return (number > 0) - (number < 0);
+}
+
+/**
+ * Runs findExtremes over the prefixes of the given points, every short one
+ * that ends in the remainder loops and longer ones, at the current kernel
+ * level, and returns true iff they all match a scan
+ */
+static bool checkExtremes(const vector<Point>& points)
+{
+	bool matched = true;
+	for(int n = 1; n <= (int)points.size(); n = (n < 20) ? n + 1 : n * 3)
+	{
+		vector<Point> prefix(points.begin(), points.begin() + n);
+		ExtremeIndexes found;
+		findExtremes(prefix.data(), n, found);
+		matched = matched and sameExtremes(found, scanExtremes(prefix));
+	}
+	return matched;
+}
+
+/**
+ * Runs orientBlock with the given line over the given points, at the current
+ * kernel level, and returns true iff every turn matches getTurnDirection
+ */
+static bool checkTurns(const Point& a, const Point& b, const Point* points, const int n)
+{
+	vector<signed char> found(n);
+	orientBlock(a, b, points, n, found.data());
+	bool matched = true;
+	for(int i = 0; i < n; i++)
+	{
+		matched = matched and found[i] == sign(getTurnDirection(&a, &b, &points[i]));
+	}
+	return matched;
+}
+
+/**
+ * Main function - runs the kernels over every kind of points at every level
+ * the CPU supports. The lines of the turns are given as pairs of points, and
+ * every line of the near collinear points has points of its own.
+ */
+int main()
+{
+	const int size = 1000;
+	const int lineCount = 40;
+	const int nearSize = size / 10;
+	vector<Point> uniform, uniformLines, full, fullLines, limits, limitLines, near, nearLines;
+	for(int i = 0; i < size; i++)
+	{
+		uniform.push_back(randomPoint(-1000, 1000));
+		full.push_back(randomPoint(INT_MIN, INT_MAX));
+		limits.push_back(limitPoint());
+	}
+	for(int i = 0; i < 2 * lineCount; i++)
+	{
+		uniformLines.push_back(randomPoint(-1000, 1000));
+		fullLines.push_back(randomPoint(INT_MIN, INT_MAX));
+		limitLines.push_back(limitPoint());
+	}
+	for(int line = 0; line < lineCount; line++)
+	{
+		Point a(0, 0);
+		Point b(0, 0);
+		nearLine(a, b);
+		nearLines.push_back(a);
+		nearLines.push_back(b);
+		for(int i = 0; i < nearSize; i++)
+		{
+			near.push_back(nearLinePoint(a, b));
+		}
+	}
+
+	const KernelLevel levels[] = {SCALAR_KERNELS, SSE41_KERNELS, AVX2_KERNELS};
+	const char* const names[] = {"Scalar", "SSE4.1", "AVX2"};
+	for(int level = 0; level < 3; level++)
+	{
+		setKernelLevel(levels[level]);
+		const string name = names[level];
+		if(getKernelLevel() != levels[level])
+		{
+			check(name + " kernels unsupported, lowered", getKernelLevel() < levels[level]);
+			continue;
+		}
+
+		check(name + " uniform extremes", checkExtremes(uniform));
+		check(name + " full range extremes", checkExtremes(full));
+		check(name + " near collinear extremes", checkExtremes(near));
+		check(name + " limits extremes", checkExtremes(limits));
+
+		/* The lengths of the arrays differ from line to line, so that the
+		 * remainder loops are run with every count of points */
+		bool uniformTurns = true;
+		bool fullTurns = true;
+		bool nearTurns = true;
+		bool limitTurns = true;
+		for(int line = 0; line < lineCount; line++)
+		{
+			const int n = size - line % 9;
+			uniformTurns = uniformTurns and checkTurns(uniformLines[2 * line], uniformLines[2 * line + 1],
+			                                           uniform.data(), n);
+			fullTurns = fullTurns and checkTurns(fullLines[2 * line], fullLines[2 * line + 1], full.data(), n);
+			nearTurns = nearTurns and checkTurns(nearLines[2 * line], nearLines[2 * line + 1],
+			                                     &near[line * nearSize], nearSize - line % 9);
+			limitTurns = limitTurns and checkTurns(limitLines[2 * line], limitLines[2 * line + 1],
+			                                       limits.data(), n);
+		}
+		check(name + " uniform turns", uniformTurns);
+		check(name + " full range turns", fullTurns);
+		check(name + " near collinear turns", nearTurns);
+		check(name + " limits turns", limitTurns);
+	}
+
+	cout << (passed ? "All SIMD kernel checks passed" : "Some SIMD kernel checks failed") << endl;
+	return passed ? 0 : 1;
+}
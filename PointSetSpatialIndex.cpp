@@ -0,0 +1,242 @@
+//PointSetSpatialIndex.cpp
+
+/**
+ * This file tests the SpatialIndex of a set, against scans over all the
+ * points of the set. The queries are checked on points spread uniformly, on
+ * a line and at the limits of the coordinates, and again after the set was
+ * changed by every operation that the index follows: add, remove in every
+ * removal mode, addRange, trim, assignment and clear.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <climits>
+#include "Point.h"
+#include "PointSet.h"
+#include "SpatialIndex.h"
+#include "TestUtils.h"
+using namespace std;
+
+/** Orders points by the x coordinate, and secondly by the y coordinate */
+static bool pointLess(const Point& p1, const Point& p2)
+{
+	return p1.getX() < p2.getX() or (p1.getX() == p2.getX() and p1.getY() < p2.getY());
+}
+
+/** Returns the squared distance between the given points */
+static unsigned __int128 squaredDistance(const Point& p1, const Point& p2)
+{
+	__int128 dx = (__int128)p1.getX() - p2.getX();
+	__int128 dy = (__int128)p1.getY() - p2.getY();
+	return dx * dx + dy * dy;
+}
+
+/** Returns the given points sorted */
+static vector<Point> sorted(vector<Point> points)
+{
+	sort(points.begin(), points.end(), pointLess);
+	return points;
+}
+
+/** Returns true iff the given vectors hold the same points, in any order */
+static bool samePoints(const vector<Point>& a, const vector<Point>& b)
+{
+	return sorted(a) == sorted(b);
+}
+
+/**
+ * Runs rectangle, nearest points and radius queries around the points of the
+ * given set and around random points within the given bounds, single and in
+ * batches, and compares them with scans over the set
+ */
+static void checkQueries(const string& name, const PointSet& set, const SpatialIndex& index,
+                         const int low, const int high)
+{
+	const int queries = 50;
+	vector<Point> points(set.getPoints(), set.getPoints() + set.size());
+	vector<Point> centers;
+	vector<Point> corners;
+	for(int i = 0; i < queries; i++)
+	{
+		if(i % 2 == 0 and !points.empty())
+		{
+			centers.push_back(points[nextNumber(0, points.size() - 1)]);
+		}
+		else
+		{
+			centers.push_back(Point(nextNumber(low, high), nextNumber(low, high)));
+		}
+		corners.push_back(Point(nextNumber(centers[i].getX(), high),
+		                        nextNumber(centers[i].getY(), high)));
+	}
+	double radius = ((double)high - low) / 10;
+
+	bool rectangles = true;
+	bool nearest = true;
+	bool radii = true;
+	for(int i = 0; i < queries; i++)
+	{
+		vector<Point> expected;
+		vector<Point> found;
+		for(size_t j = 0; j < points.size(); j++)
+		{
+			if(points[j].getX() >= centers[i].getX() and points[j].getX() <= corners[i].getX() and
+			   points[j].getY() >= centers[i].getY() and points[j].getY() <= corners[i].getY())
+			{
+				expected.push_back(points[j]);
+			}
+		}
+		index.pointsInRectangle(centers[i], corners[i], found);
+		rectangles = rectangles and samePoints(expected, found);
+
+		const int k = 1 + i % 7;
+		vector<Point> byDistance = points;
+		const Point& center = centers[i];
+		sort(byDistance.begin(), byDistance.end(), [&](const Point& p1, const Point& p2)
+		{
+			unsigned __int128 d1 = squaredDistance(p1, center);
+			unsigned __int128 d2 = squaredDistance(p2, center);
+			return d1 < d2 or (d1 == d2 and pointLess(p1, p2));
+		});
+		byDistance.resize(min((int)byDistance.size(), k), Point(0, 0));
+		found.clear();
+		index.nearestPoints(center, k, found);
+		nearest = nearest and found == byDistance;
+
+		expected.clear();
+		for(size_t j = 0; j < points.size(); j++)
+		{
+			if((long double)squaredDistance(points[j], center) <= (long double)radius * radius)
+			{
+				expected.push_back(points[j]);
+			}
+		}
+		found.clear();
+		index.pointsInRadius(center, radius, found);
+		radii = radii and samePoints(expected, found);
+	}
+	check(name + " rectangle queries", rectangles);
+	check(name + " nearest points queries", nearest);
+	check(name + " radius queries", radii);
+
+	vector<Point> batch;
+	vector<int> offsets;
+	index.pointsInRectangles(centers.data(), corners.data(), queries, batch, offsets);
+	bool batches = (int)offsets.size() == queries + 1 and offsets.back() == (int)batch.size();
+	for(int i = 0; batches and i < queries; i++)
+	{
+		vector<Point> found;
+		index.pointsInRectangle(centers[i], corners[i], found);
+		batches = found == vector<Point>(batch.begin() + offsets[i], batch.begin() + offsets[i + 1]);
+	}
+	check(name + " batch rectangle queries", batches);
+
+	const int k = 3;
+	const int count = min(k, index.size());
+	batch.clear();
+	index.nearestPoints(centers.data(), queries, k, batch);
+	batches = (int)batch.size() == queries * count;
+	for(int i = 0; batches and i < queries; i++)
+	{
+		vector<Point> found;
+		index.nearestPoints(centers[i], k, found);
+		batches = found == vector<Point>(batch.begin() + i * count, batch.begin() + (i + 1) * count);
+	}
+	check(name + " batch nearest points queries", batches);
+
+	batch.clear();
+	offsets.clear();
+	index.pointsInRadius(centers.data(), queries, radius, batch, offsets);
+	batches = (int)offsets.size() == queries + 1 and offsets.back() == (int)batch.size();
+	for(int i = 0; batches and i < queries; i++)
+	{
+		vector<Point> found;
+		index.pointsInRadius(centers[i], radius, found);
+		batches = found == vector<Point>(batch.begin() + offsets[i], batch.begin() + offsets[i + 1]);
+	}
+	check(name + " batch radius queries", batches);
+}
+
+/**
+ * Main function - runs the queries over sets of different shapes, and over a
+ * set as it is changed
+ */
+int main()
+{
+	PointSet uniform;
+	for(int i = 0; i < 2000; i++)
+	{
+		uniform.add(Point(nextNumber(-1000, 1000), nextNumber(-1000, 1000)));
+	}
+	SpatialIndex uniformIndex(uniform);
+	check("Index of every point", uniformIndex.size() == uniform.size());
+	checkQueries("Uniform", uniform, uniformIndex, -1100, 1100);
+
+	PointSet line;
+	for(int i = 0; i < 1000; i++)
+	{
+		line.add(Point(nextNumber(-1000000000, 1000000000), 7));
+	}
+	SpatialIndex lineIndex(line);
+	checkQueries("Line", line, lineIndex, -1000000000, 1000000000);
+
+	PointSet limits;
+	for(int i = 0; i < 500; i++)
+	{
+		limits.add(Point(nextNumber(INT_MIN, INT_MAX), nextNumber(INT_MIN, INT_MAX)));
+	}
+	limits.add(Point(INT_MIN, INT_MIN));
+	limits.add(Point(INT_MAX, INT_MAX));
+	SpatialIndex limitsIndex(limits);
+	checkQueries("Limits", limits, limitsIndex, INT_MIN, INT_MAX);
+	vector<Point> farthest;
+	limitsIndex.nearestPoints(Point(INT_MAX, INT_MAX), limits.size(), farthest);
+	check("Farthest point at the limits", farthest.back() == Point(INT_MIN, INT_MIN));
+
+	/* Points added past the bounding box, many times the points the grid
+	 * was built for, then removed in every removal mode */
+	PointSet changing;
+	SpatialIndex changingIndex(changing);
+	for(int i = 0; i < 3000; i++)
+	{
+		changing.add(Point(nextNumber(-10 * i, 10 * i), nextNumber(-10 * i, 10 * i)));
+	}
+	check("Index of added points", changingIndex.size() == changing.size());
+	checkQueries("Added", changing, changingIndex, -30000, 30000);
+
+	const RemovalMode modes[] = {ORDERED_REMOVAL, UNORDERED_REMOVAL, LAZY_REMOVAL};
+	for(int mode = 0; mode < 3; mode++)
+	{
+		changing.setRemovalMode(modes[mode]);
+		for(int i = 0; i < 500; i++)
+		{
+			changing.remove(*changing[nextNumber(0, changing.size() - 1)]);
+		}
+	}
+	check("Index of removed points", changingIndex.size() == changing.size());
+	checkQueries("Removed", changing, changingIndex, -30000, 30000);
+
+	vector<Point> range;
+	for(int i = 0; i < 5000; i++)
+	{
+		range.push_back(Point(nextNumber(50000, 60000), nextNumber(-5000, 5000)));
+	}
+	changing.addRange(range.data(), range.data() + range.size());
+	changing.trim(1000);
+	check("Index of a range and a trim", changingIndex.size() == changing.size());
+	checkQueries("Range and trim", changing, changingIndex, -30000, 60000);
+
+	changing = uniform;
+	check("Index of an assignment", changingIndex.size() == uniform.size());
+	checkQueries("Assigned", changing, changingIndex, -1100, 1100);
+
+	changing.clear();
+	vector<Point> none;
+	changingIndex.nearestPoints(Point(0, 0), 5, none);
+	changingIndex.pointsInRadius(Point(0, 0), 1e12, none);
+	check("Empty index", changingIndex.size() == 0 and none.empty());
+
+	cout << (passed ? "All spatial index checks passed" : "Some spatial index checks failed") << endl;
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+//PointSetStreamingHull.cpp
+
+/**
+ * This file tests the StreamingHull, against the hull computed from scratch
+ * by computeHull over all the points streamed so far. The hull is checked
+ * after every point, over streams of repeated points, of points on a line,
+ * on a vertical line, on a small grid and at the limits of the coordinates,
+ * and after every batch of points added at once.
+ */
+
+#include <iostream>
+#include <vector>
+#include <climits>
+#include "Point.h"
+#include "PointSet.h"
+#include "HullAlgorithms.h"
+#include "StreamingHull.h"
+#include "TestUtils.h"
+using namespace std;
+
+/**
+ * Streams the given points one at a time, and checks after every point that
+ * the hull and its size are those computeHull finds for all the points so
+ * far, that the point is reported as a vertex iff it is new and on the hull,
+ * and that every point is counted. Returns true iff all the checks passed.
+ */
+static bool checkStream(const vector<Point>& points)
+{
+	StreamingHull hull;
+	PointSet seen;
+	bool matched = true;
+	for(size_t i = 0; matched and i < points.size(); i++)
+	{
+		bool isNew = seen.getIndex(points[i]) == -1;
+		bool vertex = hull.add(points[i]);
+		seen.add(points[i]);
+
+		PointSet expected(seen);
+		computeHull(expected, MONOTONE_CHAIN);
+		PointSet found;
+		hull.getHull(found);
+		matched = found == expected and hull.size() == expected.size() and
+		          vertex == (isNew and expected.getIndex(points[i]) != -1) and
+		          hull.pointsSeen() == (long long)i + 1;
+	}
+	return matched;
+}
+
+/**
+ * Streams the given points in batches of random sizes, and checks after every
+ * batch that the hull is that of a stream of the same points one at a time,
+ * and that the batch counts the points the single adds report as vertices.
+ * Returns true iff all the checks passed.
+ */
+static bool checkBatches(const vector<Point>& points)
+{
+	StreamingHull batches;
+	StreamingHull singles;
+	bool matched = true;
+	for(size_t start = 0; matched and start < points.size(); )
+	{
+		int n = min((int)nextNumber(0, 30), (int)(points.size() - start));
+		int vertices = 0;
+		for(int i = 0; i < n; i++)
+		{
+			vertices += singles.add(points[start + i]);
+		}
+		PointSet expected;
+		singles.getHull(expected);
+		PointSet found;
+		matched = batches.add(&points[start], n) == vertices;
+		batches.getHull(found);
+		matched = matched and found == expected and batches.pointsSeen() == singles.pointsSeen();
+		start += n;
+	}
+	return matched;
+}
+
+/**
+ * Main function - streams every kind of points, one at a time and in batches
+ */
+int main()
+{
+	vector<Point> repeated;
+	for(int i = 0; i < 100; i++)
+	{
+		repeated.push_back(Point(3, 4));
+	}
+	repeated.push_back(Point(-3, 4));
+	for(int i = 0; i < 100; i++)
+	{
+		repeated.push_back((i % 2 == 0) ? Point(3, 4) : Point(-3, 4));
+	}
+	check("Repeated points", checkStream(repeated));
+
+	vector<Point> line;
+	for(int i = 0; i < 300; i++)
+	{
+		int x = (int)nextNumber(-1000, 1000);
+		line.push_back(Point(x, 2 * x + 1));
+	}
+	check("Points on a line", checkStream(line));
+
+	vector<Point> vertical;
+	for(int i = 0; i < 300; i++)
+	{
+		vertical.push_back(Point(5, nextNumber(-1000, 1000)));
+	}
+	check("Points on a vertical line", checkStream(vertical));
+	vertical.push_back(Point(6, 0));
+	vertical.push_back(Point(4, 2000));
+	check("Points off a vertical line", checkStream(vertical));
+
+	vector<Point> grid;
+	for(int i = 0; i < 1000; i++)
+	{
+		grid.push_back(Point(nextNumber(0, 7), nextNumber(0, 7)));
+	}
+	check("Points on a small grid", checkStream(grid));
+
+	vector<Point> uniform;
+	for(int i = 0; i < 1000; i++)
+	{
+		uniform.push_back(Point(nextNumber(-1000000, 1000000), nextNumber(-1000000, 1000000)));
+	}
+	check("Points spread uniformly", checkStream(uniform));
+
+	vector<Point> limits;
+	for(int i = 0; i < 500; i++)
+	{
+		if(nextNumber(0, 1) == 0)
+		{
+			limits.push_back(Point(LIMITS[nextNumber(0, LIMITS_COUNT - 1)],
+			                       LIMITS[nextNumber(0, LIMITS_COUNT - 1)]));
+		}
+		else
+		{
+			limits.push_back(Point(nextNumber(INT_MIN, INT_MAX), nextNumber(INT_MIN, INT_MAX)));
+		}
+	}
+	check("Points at the limits", checkStream(limits));
+
+	check("Batches of repeated points", checkBatches(repeated));
+	check("Batches on a vertical line", checkBatches(vertical));
+	check("Batches on a small grid", checkBatches(grid));
+	check("Batches at the limits", checkBatches(limits));
+
+	StreamingHull empty;
+	PointSet none;
+	empty.getHull(none);
+	check("Empty stream", empty.size() == 0 and none.size() == 0 and empty.pointsSeen() == 0);
+
+	cout << (passed ? "All streaming hull checks passed" : "Some streaming hull checks failed") << endl;
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+// PointWriter.cpp
+#include "PointWriter.h"
+#include "HullStats.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+using namespace std;
+
+// --------------------------------------------------------------------------------------
+// This file contains the implementation of the class PointWriter.
+// --------------------------------------------------------------------------------------
+
+/* The size of the buffer the points are formatted into */
+static const size_t WRITE_BLOCK_SIZE = 1 << 20;
+
+/**
+ * Constructs a writer to the given file descriptor, allocating its buffer
+ */
+PointWriter::PointWriter(const int fd):_fd(fd), _buffer(nullptr), _used(0), _failed(false)
+{
+	if((_buffer = (char*)malloc(WRITE_BLOCK_SIZE)) == nullptr)
+	{
+		exit(1);
+	}
+}
+
+
+/**
+ * Destructor
+ */
+PointWriter::~PointWriter()
+{
+	flush();
+	free(_buffer);
+}
+
+
+/** Writes the given point, formatted in place in the buffer */
+template <typename Coordinate>
+void PointWriter::write(const BasicPoint<Coordinate>& point)
+{
+	_reserve(BasicPoint<Coordinate>::MAX_TEXT_LENGTH + 1);
+	char* end = point.format(_buffer + _used);
+	*end++ = '\n';
+	_used = end - _buffer;
+}
+
+
+/** Writes the given n points. The buffer is checked for room once for as
+ * many points as are sure to fit in it. */
+template <typename Coordinate>
+void PointWriter::write(const BasicPoint<Coordinate>* points, const int n)
+{
+	const size_t lineLength = BasicPoint<Coordinate>::MAX_TEXT_LENGTH + 1;
+	int i = 0;
+	while(i < n)
+	{
+		_reserve(lineLength);
+		int fitting = (int)min((WRITE_BLOCK_SIZE - _used) / lineLength, (size_t)(n - i));
+		char* end = _buffer + _used;
+		for(const int last = i + fitting; i < last; i++)
+		{
+			end = points[i].format(end);
+			*end++ = '\n';
+		}
+		_used = end - _buffer;
+	}
+}
+
+
+/** Writes the given bytes, copying them into the buffer unless they fill it
+ * up, in which case they are written directly */
+void PointWriter::write(const char* data, const size_t length)
+{
+	if(length >= WRITE_BLOCK_SIZE)
+	{
+		flush();
+		_writeOut(data, length);
+		return;
+	}
+	_reserve(length);
+	memcpy(_buffer + _used, data, length);
+	_used += length;
+}
+
+
+/** Writes the given text as it is */
+void PointWriter::write(const string& text)
+{
+	write(text.data(), text.size());
+}
+
+
+/** Writes out the buffer */
+bool PointWriter::flush()
+{
+	_writeOut(_buffer, _used);
+	_used = 0;
+	return !_failed;
+}
+
+
+/** Returns true iff a write has failed */
+bool PointWriter::failed() const
+{
+	return _failed;
+}
+
+
+/** Writes out the buffer if fewer than the given number of characters are
+ * free in it */
+void PointWriter::_reserve(const size_t length)
+{
+	if(WRITE_BLOCK_SIZE - _used < length)
+	{
+		flush();
+	}
+}
+
+
+/** Writes the given bytes to the descriptor. Nothing is written once a write
+ * has failed. */
+void PointWriter::_writeOut(const char* data, size_t length)
+{
+	while(length > 0 and !_failed)
+	{
+		ssize_t written = ::write(_fd, data, length);
+		if(written < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			_failed = true;
+			return;
+		}
+		data += written;
+		length -= written;
+		HULL_COUNT(BYTES_WRITTEN, written);
+	}
+}
+
+
+#define INSTANTIATE_POINT_WRITER(Coordinate) \
+	template void PointWriter::write(const BasicPoint<Coordinate>& point); \
+	template void PointWriter::write(const BasicPoint<Coordinate>* points, const int n);
+
+INSTANTIATE_POINT_WRITER(int16_t)
+INSTANTIATE_POINT_WRITER(int32_t)
+INSTANTIATE_POINT_WRITER(int64_t)
+INSTANTIATE_POINT_WRITER(double)
@@ -0,0 +1,93 @@
+// PointWriter.h
+#ifndef POINT_WRITER_H
+#define POINT_WRITER_H
+
+#include <cstddef>
+#include <string>
+#include "Point.h"
+#include "PointSet.h"
+
+using namespace std;
+
+/**
+ * This class writes points to a file descriptor, one point per line in the
+ * format "<x>,<y>", the format read by PointReader. The points are formatted
+ * straight into a single buffer of 1MB, which is written out whenever it
+ * fills up, so writing takes no allocations per point and one system call
+ * per megabyte. Text and raw bytes can be written between the points, and
+ * blocks larger than the buffer are written directly. A failed write is
+ * remembered, and everything written after it is dropped.
+ */
+class PointWriter
+{
+public:
+
+	/**
+	 * Constructs a writer to the given file descriptor. The descriptor is not
+	 * closed by the writer.
+	 */
+	PointWriter(const int fd);
+
+	/**
+	 * Destructor. Writes out whatever is left in the buffer.
+	 */
+	~PointWriter();
+
+	/** Writes the given point, followed by a line break */
+	template <typename Coordinate>
+	void write(const BasicPoint<Coordinate>& point);
+
+	/** Writes the given n points, each followed by a line break */
+	template <typename Coordinate>
+	void write(const BasicPoint<Coordinate>* points, const int n);
+
+	/** Writes the points of the given set, in the format of its toString() */
+	template <typename Coordinate>
+	void write(const BasicPointSet<Coordinate>& set);
+
+	/** Writes the given bytes as they are */
+	void write(const char* data, const size_t length);
+
+	/** Writes the given text as it is */
+	void write(const string& text);
+
+	/**
+	 * Writes out the buffer, so that everything written so far is seen at
+	 * once
+	 * @return True iff every write so far succeeded
+	 */
+	bool flush();
+
+	/** Returns true iff a write has failed */
+	bool failed() const;
+
+private:
+
+	int _fd;
+	char* _buffer;
+	size_t _used; // The number of characters in the buffer
+	bool _failed;
+
+	/** Writes out the buffer if fewer than the given number of characters
+	 * are free in it */
+	void _reserve(const size_t length);
+
+	/** Writes the given bytes to the descriptor, resuming interrupted and
+	 * partial writes */
+	void _writeOut(const char* data, size_t length);
+
+	PointWriter(const PointWriter&);
+	PointWriter& operator=(const PointWriter&);
+};
+
+/**
+ * Writes the points of the given set, in order. Defined here, so that only
+ * the programs writing sets are linked with them.
+ */
+template <typename Coordinate>
+void PointWriter::write(const BasicPointSet<Coordinate>& set)
+{
+	write(set.getPoints(), set.size());
+}
+
+#endif
@@ -0,0 +1,457 @@
+// SimdKernels.cpp
+#include "SimdKernels.h"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KERNELS_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// --------------------------------------------------------------------------------------
+// This file contains the implementation of the vectorized point kernels.
+// --------------------------------------------------------------------------------------
+
+
+/* The kernels read the points as an array of interleaved x and y coordinates */
+static_assert(sizeof(Point) == 2 * sizeof(int), "Point must be a packed pair of ints");
+
+/* The relative error bound of a 2x2 determinant computed in double precision,
+ * from exactly represented differences (Shewchuk's ccwerrboundA). The
+ * coordinates are ints, so all the differences are exact in a double. */
+static const double ORIENTATION_ERROR_BOUND = 3.3306690738754716e-16;
+
+/* The number of directions searched for by findExtremes */
+static const int DIRECTIONS = 8;
+
+
+/** Returns the coordinates of the given points as an array of interleaved x
+ * and y values */
+static inline const int* coordinates(const Point* points)
+{
+	return reinterpret_cast<const int*>(points);
+}
+
+
+/** Returns the exact turn formed by the line from (ax,ay) to (bx,by) and the
+ * point (px,py), as -1, 0 or 1 */
+static inline signed char exactTurn(const long long ax, const long long ay,
+                                    const long long bx, const long long by,
+                                    const long long px, const long long py)
+{
+	__int128 cross = (__int128)(bx - ax) * (py - ay) - (__int128)(by - ay) * (px - ax);
+	return (cross > 0) - (cross < 0);
+}
+
+
+/**
+ * The state of the search for the extreme points, in the order of
+ * minX, maxX, minY, maxY, minSum, maxSum, minDifference, maxDifference.
+ * Values are held as doubles, in which x + y and x - y are exact.
+ */
+struct ExtremeSearch
+{
+	double values[DIRECTIONS];
+	int indexes[DIRECTIONS];
+
+	/** Offers a candidate value for the given direction. A candidate replaces
+	 * the current extreme if it is strictly better, or equally good with a
+	 * smaller index. Even directions are minimums, odd ones maximums. */
+	void offer(const int direction, const double value, const int index)
+	{
+		double current = values[direction];
+		bool better = (direction % 2 == 0) ? value < current : value > current;
+		if(better or (value == current and index < indexes[direction]))
+		{
+			values[direction] = value;
+			indexes[direction] = index;
+		}
+	}
+
+	/** Offers the point with the given coordinates for all directions */
+	void offerPoint(const double x, const double y, const int index)
+	{
+		offer(0, x, index);
+		offer(1, x, index);
+		offer(2, y, index);
+		offer(3, y, index);
+		offer(4, x + y, index);
+		offer(5, x + y, index);
+		offer(6, x - y, index);
+		offer(7, x - y, index);
+	}
+
+	/** Starts the search with the first point */
+	void start(const Point* points)
+	{
+		for(int d = 0; d < DIRECTIONS; d++)
+		{
+			indexes[d] = 0;
+		}
+		double x = points[0].getX();
+		double y = points[0].getY();
+		values[0] = values[1] = x;
+		values[2] = values[3] = y;
+		values[4] = values[5] = x + y;
+		values[6] = values[7] = x - y;
+	}
+
+	/** Copies the indexes found to the given result */
+	void finish(ExtremeIndexes& result) const
+	{
+		result.minX = indexes[0];
+		result.maxX = indexes[1];
+		result.minY = indexes[2];
+		result.maxY = indexes[3];
+		result.minSum = indexes[4];
+		result.maxSum = indexes[5];
+		result.minDifference = indexes[6];
+		result.maxDifference = indexes[7];
+	}
+};
+
+
+/** Scalar version of findExtremes, over the points from the given index on */
+static void findExtremesScalar(const Point* points, const int start, const int n,
+                               ExtremeSearch& search)
+{
+	for(int i = start; i < n; i++)
+	{
+		search.offerPoint(points[i].getX(), points[i].getY(), i);
+	}
+}
+
+
+/** Scalar version of orientBlock, over the points from the given index on */
+static void orientBlockScalar(const Point& a, const Point& b, const Point* points,
+                              const int start, const int n, signed char* turns)
+{
+	for(int i = start; i < n; i++)
+	{
+		turns[i] = exactTurn(a.getX(), a.getY(), b.getX(), b.getY(),
+		                     points[i].getX(), points[i].getY());
+	}
+}
+
+
+#ifdef KERNELS_X86
+
+/**
+ * Writes the turns of a group of lanes starting at the given index, given the
+ * masks of the lanes certain to be left and right turns. The remaining lanes
+ * are too close to the line for the floating point sign to be trusted, and
+ * are computed exactly.
+ */
+static inline void writeTurns(const Point& a, const Point& b, const Point* points, const int start,
+                              const int lanes, const int positive, const int negative,
+                              signed char* turns)
+{
+	for(int lane = 0; lane < lanes; lane++)
+	{
+		turns[start + lane] = (signed char)(((positive >> lane) & 1) - ((negative >> lane) & 1));
+	}
+	int uncertain = ~(positive | negative) & ((1 << lanes) - 1);
+	while(uncertain != 0)
+	{
+		int lane = __builtin_ctz(uncertain);
+		orientBlockScalar(a, b, points, start + lane, start + lane + 1, turns);
+		uncertain &= uncertain - 1;
+	}
+}
+
+
+/* -------------------------------- AVX2 ---------------------------------------- */
+
+/** Updates the extreme values and indexes held in the given vectors with
+ * the candidates of 4 points. */
+__attribute__((target("avx2")))
+static inline void updateAvx2(__m256d& best, __m256d& bestIndexes, const __m256d candidates,
+                              const __m256d indexes, const int predicate)
+{
+	__m256d better = (predicate == _CMP_LT_OQ) ? _mm256_cmp_pd(candidates, best, _CMP_LT_OQ)
+	                                           : _mm256_cmp_pd(candidates, best, _CMP_GT_OQ);
+	best = _mm256_blendv_pd(best, candidates, better);
+	bestIndexes = _mm256_blendv_pd(bestIndexes, indexes, better);
+}
+
+
+/** AVX2 version of findExtremes. Every lane follows its own extremes, which
+ * are merged at the end, so the first index is taken among equal extremes. */
+__attribute__((target("avx2")))
+static void findExtremesAvx2(const Point* points, const int n, ExtremeSearch& search)
+{
+	const int* coords = coordinates(points);
+	const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+	__m256d best[DIRECTIONS];
+	__m256d bestIndexes[DIRECTIONS];
+	for(int d = 0; d < DIRECTIONS; d++)
+	{
+		best[d] = _mm256_set1_pd(search.values[d]);
+		bestIndexes[d] = _mm256_setzero_pd();
+	}
+
+	__m256d indexes = _mm256_setr_pd(0, 1, 2, 3);
+	const __m256d step = _mm256_set1_pd(4);
+	int i = 0;
+	for(; i + 4 <= n; i += 4)
+	{
+		__m256i pair = _mm256_loadu_si256((const __m256i*)(coords + 2 * i));
+		pair = _mm256_permutevar8x32_epi32(pair, deinterleave);
+		__m256d x = _mm256_cvtepi32_pd(_mm256_castsi256_si128(pair));
+		__m256d y = _mm256_cvtepi32_pd(_mm256_extracti128_si256(pair, 1));
+		__m256d sum = _mm256_add_pd(x, y);
+		__m256d difference = _mm256_sub_pd(x, y);
+
+		updateAvx2(best[0], bestIndexes[0], x, indexes, _CMP_LT_OQ);
+		updateAvx2(best[1], bestIndexes[1], x, indexes, _CMP_GT_OQ);
+		updateAvx2(best[2], bestIndexes[2], y, indexes, _CMP_LT_OQ);
+		updateAvx2(best[3], bestIndexes[3], y, indexes, _CMP_GT_OQ);
+		updateAvx2(best[4], bestIndexes[4], sum, indexes, _CMP_LT_OQ);
+		updateAvx2(best[5], bestIndexes[5], sum, indexes, _CMP_GT_OQ);
+		updateAvx2(best[6], bestIndexes[6], difference, indexes, _CMP_LT_OQ);
+		updateAvx2(best[7], bestIndexes[7], difference, indexes, _CMP_GT_OQ);
+		indexes = _mm256_add_pd(indexes, step);
+	}
+
+	double values[4];
+	double laneIndexes[4];
+	for(int d = 0; d < DIRECTIONS; d++)
+	{
+		_mm256_storeu_pd(values, best[d]);
+		_mm256_storeu_pd(laneIndexes, bestIndexes[d]);
+		for(int lane = 0; lane < 4; lane++)
+		{
+			search.offer(d, values[lane], (int)laneIndexes[lane]);
+		}
+	}
+	findExtremesScalar(points, i, n, search);
+}
+
+
+/** AVX2 version of orientBlock */
+__attribute__((target("avx2")))
+static void orientBlockAvx2(const Point& a, const Point& b, const Point* points, const int n,
+                            signed char* turns)
+{
+	const int* coords = coordinates(points);
+	const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+	const __m256d ax = _mm256_set1_pd(a.getX());
+	const __m256d ay = _mm256_set1_pd(a.getY());
+	const __m256d dx = _mm256_set1_pd((double)b.getX() - a.getX());
+	const __m256d dy = _mm256_set1_pd((double)b.getY() - a.getY());
+	const __m256d errorBound = _mm256_set1_pd(ORIENTATION_ERROR_BOUND);
+	const __m256d signMask = _mm256_set1_pd(-0.0);
+
+	int i = 0;
+	for(; i + 4 <= n; i += 4)
+	{
+		__m256i pair = _mm256_loadu_si256((const __m256i*)(coords + 2 * i));
+		pair = _mm256_permutevar8x32_epi32(pair, deinterleave);
+		__m256d px = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(pair)), ax);
+		__m256d py = _mm256_sub_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(pair, 1)), ay);
+
+		__m256d left = _mm256_mul_pd(dx, py);
+		__m256d right = _mm256_mul_pd(dy, px);
+		__m256d determinant = _mm256_sub_pd(left, right);
+		__m256d bound = _mm256_mul_pd(errorBound, _mm256_add_pd(_mm256_andnot_pd(signMask, left),
+		                                                        _mm256_andnot_pd(signMask, right)));
+
+		int positive = _mm256_movemask_pd(_mm256_cmp_pd(determinant, bound, _CMP_GT_OQ));
+		int negative = _mm256_movemask_pd(_mm256_cmp_pd(determinant,
+		                                                _mm256_xor_pd(bound, signMask),
+		                                                _CMP_LT_OQ));
+		writeTurns(a, b, points, i, 4, positive, negative, turns);
+	}
+	orientBlockScalar(a, b, points, i, n, turns);
+}
+
+
+/* ------------------------------- SSE4.1 --------------------------------------- */
+
+/** Updates the extreme values and indexes held in the given vectors with
+ * the candidates of 2 points. */
+__attribute__((target("sse4.1")))
+static inline void updateSse41(__m128d& best, __m128d& bestIndexes, const __m128d candidates,
+                               const __m128d indexes, const bool minimum)
+{
+	__m128d better = minimum ? _mm_cmplt_pd(candidates, best) : _mm_cmpgt_pd(candidates, best);
+	best = _mm_blendv_pd(best, candidates, better);
+	bestIndexes = _mm_blendv_pd(bestIndexes, indexes, better);
+}
+
+
+/** SSE4.1 version of findExtremes */
+__attribute__((target("sse4.1")))
+static void findExtremesSse41(const Point* points, const int n, ExtremeSearch& search)
+{
+	const int* coords = coordinates(points);
+	__m128d best[DIRECTIONS];
+	__m128d bestIndexes[DIRECTIONS];
+	for(int d = 0; d < DIRECTIONS; d++)
+	{
+		best[d] = _mm_set1_pd(search.values[d]);
+		bestIndexes[d] = _mm_setzero_pd();
+	}
+
+	__m128d indexes = _mm_setr_pd(0, 1);
+	const __m128d step = _mm_set1_pd(2);
+	int i = 0;
+	for(; i + 2 <= n; i += 2)
+	{
+		__m128i pair = _mm_loadu_si128((const __m128i*)(coords + 2 * i));
+		pair = _mm_shuffle_epi32(pair, _MM_SHUFFLE(3, 1, 2, 0));
+		__m128d x = _mm_cvtepi32_pd(pair);
+		__m128d y = _mm_cvtepi32_pd(_mm_unpackhi_epi64(pair, pair));
+		__m128d sum = _mm_add_pd(x, y);
+		__m128d difference = _mm_sub_pd(x, y);
+
+		updateSse41(best[0], bestIndexes[0], x, indexes, true);
+		updateSse41(best[1], bestIndexes[1], x, indexes, false);
+		updateSse41(best[2], bestIndexes[2], y, indexes, true);
+		updateSse41(best[3], bestIndexes[3], y, indexes, false);
+		updateSse41(best[4], bestIndexes[4], sum, indexes, true);
+		updateSse41(best[5], bestIndexes[5], sum, indexes, false);
+		updateSse41(best[6], bestIndexes[6], difference, indexes, true);
+		updateSse41(best[7], bestIndexes[7], difference, indexes, false);
+		indexes = _mm_add_pd(indexes, step);
+	}
+
+	double values[2];
+	double laneIndexes[2];
+	for(int d = 0; d < DIRECTIONS; d++)
+	{
+		_mm_storeu_pd(values, best[d]);
+		_mm_storeu_pd(laneIndexes, bestIndexes[d]);
+		for(int lane = 0; lane < 2; lane++)
+		{
+			search.offer(d, values[lane], (int)laneIndexes[lane]);
+		}
+	}
+	findExtremesScalar(points, i, n, search);
+}
+
+
+/** SSE4.1 version of orientBlock */
+__attribute__((target("sse4.1")))
+static void orientBlockSse41(const Point& a, const Point& b, const Point* points, const int n,
+                             signed char* turns)
+{
+	const int* coords = coordinates(points);
+	const __m128d ax = _mm_set1_pd(a.getX());
+	const __m128d ay = _mm_set1_pd(a.getY());
+	const __m128d dx = _mm_set1_pd((double)b.getX() - a.getX());
+	const __m128d dy = _mm_set1_pd((double)b.getY() - a.getY());
+	const __m128d errorBound = _mm_set1_pd(ORIENTATION_ERROR_BOUND);
+	const __m128d signMask = _mm_set1_pd(-0.0);
+
+	int i = 0;
+	for(; i + 2 <= n; i += 2)
+	{
+		__m128i pair = _mm_loadu_si128((const __m128i*)(coords + 2 * i));
+		pair = _mm_shuffle_epi32(pair, _MM_SHUFFLE(3, 1, 2, 0));
+		__m128d px = _mm_sub_pd(_mm_cvtepi32_pd(pair), ax);
+		__m128d py = _mm_sub_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(pair, pair)), ay);
+
+		__m128d left = _mm_mul_pd(dx, py);
+		__m128d right = _mm_mul_pd(dy, px);
+		__m128d determinant = _mm_sub_pd(left, right);
+		__m128d bound = _mm_mul_pd(errorBound, _mm_add_pd(_mm_andnot_pd(signMask, left),
+		                                                  _mm_andnot_pd(signMask, right)));
+
+		int positive = _mm_movemask_pd(_mm_cmpgt_pd(determinant, bound));
+		int negative = _mm_movemask_pd(_mm_cmplt_pd(determinant, _mm_xor_pd(bound, signMask)));
+		writeTurns(a, b, points, i, 2, positive, negative, turns);
+	}
+	orientBlockScalar(a, b, points, i, n, turns);
+}
+
+#endif
+
+
+/* ------------------------------- Dispatch ------------------------------------- */
+
+/** Returns the best instruction set supported by the running CPU */
+static KernelLevel getSupportedLevel()
+{
+#ifdef KERNELS_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+	{
+		return AVX2_KERNELS;
+	}
+	if(__builtin_cpu_supports("sse4.1"))
+	{
+		return SSE41_KERNELS;
+	}
+#endif
+	return SCALAR_KERNELS;
+}
+
+static const KernelLevel SUPPORTED_LEVEL = getSupportedLevel();
+static KernelLevel currentLevel = SUPPORTED_LEVEL;
+
+
+/**
+ * Finds the extreme points of the given array of points in 8 directions, with
+ * the kernel of the current instruction set.
+ */
+void findExtremes(const Point* points, const int n, ExtremeIndexes& result)
+{
+	ExtremeSearch search;
+	search.start(points);
+	switch(currentLevel)
+	{
+#ifdef KERNELS_X86
+		case AVX2_KERNELS:
+			findExtremesAvx2(points, n, search);
+			break;
+		case SSE41_KERNELS:
+			findExtremesSse41(points, n, search);
+			break;
+#endif
+		default:
+			findExtremesScalar(points, 1, n, search);
+			break;
+	}
+	search.finish(result);
+}
+
+
+/**
+ * Writes the turn formed by the line from a to b and each of the given points,
+ * with the kernel of the current instruction set.
+ */
+void orientBlock(const Point& a, const Point& b, const Point* points, const int n,
+                 signed char* turns)
+{
+	switch(currentLevel)
+	{
+#ifdef KERNELS_X86
+		case AVX2_KERNELS:
+			orientBlockAvx2(a, b, points, n, turns);
+			break;
+		case SSE41_KERNELS:
+			orientBlockSse41(a, b, points, n, turns);
+			break;
+#endif
+		default:
+			orientBlockScalar(a, b, points, 0, n, turns);
+			break;
+	}
+}
+
+
+/** Returns the instruction set the kernels currently run with */
+KernelLevel getKernelLevel()
+{
+	return currentLevel;
+}
+
+
+/** Sets the instruction set the kernels run with, lowered to the best one
+ * supported */
+void setKernelLevel(const KernelLevel level)
+{
+	currentLevel = (level < SUPPORTED_LEVEL) ? level : SUPPORTED_LEVEL;
+}
@@ -0,0 +1,69 @@
+// SimdKernels.h
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include "Point.h"
+
+/**
+ * This file declares the vectorized inner loops used when filtering points for
+ * the convex hull. Every kernel runs over a contiguous array of points, such as
+ * the one returned by PointSet::getPoints. Each kernel has an AVX2, an SSE4.1
+ * and a scalar version, and the best version supported by the running CPU is
+ * chosen at runtime. All versions return exactly the same results.
+ */
+
+/**
+ * The instruction sets the kernels can be run with, from the slowest to the
+ * fastest.
+ */
+enum KernelLevel
+{
+	SCALAR_KERNELS,
+	SSE41_KERNELS,
+	AVX2_KERNELS
+};
+
+/**
+ * The indexes of points attaining the extreme values of x, y, x + y and x - y
+ * within an array of points. When several points attain the same extreme
+ * value, the first of them is taken.
+ */
+struct ExtremeIndexes
+{
+	int minX;
+	int maxX;
+	int minY;
+	int maxY;
+	int minSum;
+	int maxSum;
+	int minDifference;
+	int maxDifference;
+};
+
+/**
+ * Finds the extreme points of the given array of points in 8 directions, in a
+ * single pass over the array. Requires n to be positive.
+ */
+void findExtremes(const Point* points, const int n, ExtremeIndexes& result);
+
+/**
+ * Writes, for each of the given points, the turn formed by the line from a to
+ * b and the point: 1 for a left turn, -1 for a right turn, and 0 if the three
+ * points are on the same line. Same as the sign of getTurnDirection(a, b, p).
+ * The turns are computed in floating point, several points at a time, and only
+ * points too close to the line for the floating point result to be certain
+ * are checked again with exact integer arithmetic.
+ */
+void orientBlock(const Point& a, const Point& b, const Point* points, const int n,
+                 signed char* turns);
+
+/** Returns the instruction set the kernels currently run with */
+KernelLevel getKernelLevel();
+
+/**
+ * Sets the instruction set the kernels run with. A level not supported by the
+ * running CPU is lowered to the best supported one.
+ */
+void setKernelLevel(const KernelLevel level);
+
+#endif
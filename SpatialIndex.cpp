@@ -0,0 +1,482 @@
+// SpatialIndex.cpp
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace std;
+
+// --------------------------------------------------------------------------------------
+// This file contains the implementation of the class SpatialIndex.
+// --------------------------------------------------------------------------------------
+
+
+/* The index of a missing node */
+static const int NO_NODE = -1;
+
+/* The number of points the grid is sized to hold in every cell */
+static const int POINTS_PER_CELL = 2;
+
+/* The number of updates a grid of few points takes before it is rebuilt, so
+ * that a set built up from nothing isn't rebuilt after every point */
+static const int MIN_REBUILD_UPDATES = 64;
+
+/* A reach past which a radius covers all points with 32 bit coordinates */
+static const double MAX_REACH = 17179869184.0; // 2^34
+
+
+/** Returns the squared distance between the given points. The differences of
+ * 32 bit coordinates take 33 bits, so each square is taken of the magnitude of
+ * a difference, in 64 bits, and their sum in 128 bits. */
+static inline unsigned __int128 squaredDistance(const Point& p1, const Point& p2)
+{
+	long long dx = (long long)p1.getX() - p2.getX();
+	long long dy = (long long)p1.getY() - p2.getY();
+	unsigned long long x = dx < 0 ? -dx : dx;
+	unsigned long long y = dy < 0 ? -dy : dy;
+	return (unsigned __int128)(x * x) + y * y;
+}
+
+
+/** Returns true iff the given point is at a distance of at most the given
+ * radius from the given center */
+static inline bool inRadius(const Point& point, const Point& center, const long double squaredRadius)
+{
+	return (long double)squaredDistance(point, center) <= squaredRadius;
+}
+
+
+/** Orders the neighbours by distance, and then by the x and the y coordinates */
+bool SpatialIndex::Neighbour::operator<(const Neighbour& other) const
+{
+	if(distance != other.distance)
+	{
+		return distance < other.distance;
+	}
+	if(point.getX() != other.point.getX())
+	{
+		return point.getX() < other.point.getX();
+	}
+	return point.getY() < other.point.getY();
+}
+
+
+/**
+ * Builds the index of the given set, and attaches it to the set. The index
+ * must be destroyed before the set.
+ */
+SpatialIndex::SpatialIndex(PointSet& set): _set(set)
+{
+	setReset(set);
+	_set.addObserver(this);
+}
+
+
+/**
+ * Destructor. Detaches the index from its set.
+ */
+SpatialIndex::~SpatialIndex()
+{
+	_set.removeObserver(this);
+}
+
+
+/**
+ * Returns the number of points in the index
+ */
+int SpatialIndex::size() const
+{
+	return _size;
+}
+
+
+/**
+ * Sizes the grid for the given points, and fills it with them. The cells are
+ * square, of the side that gives the bounding box of the points about
+ * n / POINTS_PER_CELL cells, and at least 1 / (n / POINTS_PER_CELL) of its
+ * longer side, so that points on a line don't spread over more cells than
+ * that either. The points are placed by a counting sort over their cells, so
+ * the nodes of every cell are consecutive.
+ */
+void SpatialIndex::_build(const Point* points, const int n)
+{
+	_minX = 0;
+	_minY = 0;
+	long long maxX = 0;
+	long long maxY = 0;
+	if(n > 0)
+	{
+		_minX = maxX = points[0].getX();
+		_minY = maxY = points[0].getY();
+	}
+	for(int i = 1; i < n; i++)
+	{
+		_minX = min(_minX, (long long)points[i].getX());
+		maxX = max(maxX, (long long)points[i].getX());
+		_minY = min(_minY, (long long)points[i].getY());
+		maxY = max(maxY, (long long)points[i].getY());
+	}
+
+	long long width = maxX - _minX + 1;
+	long long height = maxY - _minY + 1;
+	long long cells = max(1, n / POINTS_PER_CELL);
+	_cellSize = (long long)ceil(sqrt((double)width * (double)height / cells));
+	_cellSize = max(_cellSize, (max(width, height) + cells - 1) / cells);
+	_cellSize = max(_cellSize, 1LL);
+	_columns = (int)((width + _cellSize - 1) / _cellSize);
+	_rows = (int)((height + _cellSize - 1) / _cellSize);
+
+	vector<int> cellOf(n);
+	vector<int> starts(_columns * _rows + 1, 0);
+	for(int i = 0; i < n; i++)
+	{
+		cellOf[i] = _row(points[i].getY()) * _columns + _column(points[i].getX());
+		starts[cellOf[i] + 1]++;
+	}
+	for(size_t cell = 1; cell < starts.size(); cell++)
+	{
+		starts[cell] += starts[cell - 1];
+	}
+
+	Node unused = {Point(0, 0), NO_NODE};
+	_nodes.assign(n, unused);
+	_freeNodes.clear();
+	_cells.assign(_columns * _rows, NO_NODE);
+	for(int i = 0; i < n; i++)
+	{
+		int node = starts[cellOf[i]]++;
+		_nodes[node].point = points[i];
+		_nodes[node].next = _cells[cellOf[i]];
+		_cells[cellOf[i]] = node;
+	}
+
+	_size = n;
+	_builtSize = n;
+	_updates = 0;
+}
+
+
+/** Rebuilds the grid for the points it holds, collected from its cells */
+void SpatialIndex::_rebuild()
+{
+	vector<Point> points;
+	points.reserve(_size);
+	for(size_t cell = 0; cell < _cells.size(); cell++)
+	{
+		for(int node = _cells[cell]; node != NO_NODE; node = _nodes[node].next)
+		{
+			points.push_back(_nodes[node].point);
+		}
+	}
+	_build(points.data(), points.size());
+}
+
+
+/**
+ * Counts an update, and rebuilds the grid once the updates since it was built
+ * outnumber its points. The grid is rebuilt from its own points rather than
+ * from the set, since the set notifies the points of a range only once all of
+ * them were added or removed.
+ */
+void SpatialIndex::_countUpdate()
+{
+	if(++_updates > max(_builtSize, MIN_REBUILD_UPDATES))
+	{
+		_rebuild();
+	}
+}
+
+
+/** Returns the column of the given x coordinate, clamped to the grid */
+int SpatialIndex::_column(const long long x) const
+{
+	if(x < _minX)
+	{
+		return 0;
+	}
+	if(x - _minX >= _columns * _cellSize)
+	{
+		return _columns - 1;
+	}
+	return (int)((x - _minX) / _cellSize);
+}
+
+
+/** Returns the row of the given y coordinate, clamped to the grid */
+int SpatialIndex::_row(const long long y) const
+{
+	if(y < _minY)
+	{
+		return 0;
+	}
+	if(y - _minY >= _rows * _cellSize)
+	{
+		return _rows - 1;
+	}
+	return (int)((y - _minY) / _cellSize);
+}
+
+
+/** Adds a point added to the set to the front of its cell, in a freed node if
+ * there is one */
+void SpatialIndex::pointAdded(const Point& point)
+{
+	int cell = _row(point.getY()) * _columns + _column(point.getX());
+	Node added = {point, _cells[cell]};
+	if(_freeNodes.empty())
+	{
+		_cells[cell] = _nodes.size();
+		_nodes.push_back(added);
+	}
+	else
+	{
+		_cells[cell] = _freeNodes.back();
+		_freeNodes.pop_back();
+		_nodes[_cells[cell]] = added;
+	}
+	_size++;
+	_countUpdate();
+}
+
+
+/** Removes a point removed from the set from its cell */
+void SpatialIndex::pointRemoved(const Point& point)
+{
+	int* link = &_cells[_row(point.getY()) * _columns + _column(point.getX())];
+	while(*link != NO_NODE and !(_nodes[*link].point == point))
+	{
+		link = &_nodes[*link].next;
+	}
+	if(*link == NO_NODE)
+	{
+		return;
+	}
+	_freeNodes.push_back(*link);
+	*link = _nodes[*link].next;
+	_size--;
+	_countUpdate();
+}
+
+
+/** Rebuilds the grid for all the points of the set */
+void SpatialIndex::setReset(const PointSet& set)
+{
+	_build(set.getPoints(), set.size());
+}
+
+
+/** Appends the points whose coordinates lie between the given bounds,
+ * inclusive, to the given vector, visiting only the cells that overlap them */
+void SpatialIndex::_collect(const long long lowX, const long long lowY, const long long highX,
+                            const long long highY, vector<Point>& result) const
+{
+	if(lowX > highX or lowY > highY)
+	{
+		return;
+	}
+	int column1 = _column(lowX);
+	int column2 = _column(highX);
+	int row2 = _row(highY);
+	for(int row = _row(lowY); row <= row2; row++)
+	{
+		for(int column = column1; column <= column2; column++)
+		{
+			for(int node = _cells[row * _columns + column]; node != NO_NODE; node = _nodes[node].next)
+			{
+				const Point& point = _nodes[node].point;
+				if(point.getX() >= lowX and point.getX() <= highX and point.getY() >= lowY and
+				   point.getY() <= highY)
+				{
+					result.push_back(point);
+				}
+			}
+		}
+	}
+}
+
+
+/**
+ * Appends the points whose coordinates lie between those of the given
+ * corners, inclusive, to the given vector, in no particular order
+ */
+void SpatialIndex::pointsInRectangle(const Point& low, const Point& high, vector<Point>& result) const
+{
+	_collect(low.getX(), low.getY(), high.getX(), high.getY(), result);
+}
+
+
+/**
+ * Leaves the k nearest points to the given point in the given heap, nearest
+ * first. The cells are visited in rings around the cell of the point, the
+ * cells of ring r being r cells away from it in x or in y, and the k nearest
+ * points seen so far are kept in a heap whose top is the farthest of them.
+ * Every point of a cell r rings away is at least (r - 1) cells away from the
+ * point, even if it lies past the border of the grid, so the search stops
+ * once the heap is full and its top is nearer than the next ring.
+ */
+void SpatialIndex::_nearest(const Point& point, const int k, vector<Neighbour>& heap) const
+{
+	heap.clear();
+	if(k <= 0 or _size == 0)
+	{
+		return;
+	}
+	int centerColumn = _column(point.getX());
+	int centerRow = _row(point.getY());
+	int rings = max(max(centerColumn, _columns - 1 - centerColumn),
+	                max(centerRow, _rows - 1 - centerRow));
+	for(int ring = 0; ring <= rings; ring++)
+	{
+		int row1 = max(centerRow - ring, 0);
+		int row2 = min(centerRow + ring, _rows - 1);
+		for(int row = row1; row <= row2; row++)
+		{
+			/* The rows at the edges of the ring are visited whole, and the
+			 * others only at the two columns of the ring */
+			bool edgeRow = row == centerRow - ring or row == centerRow + ring;
+			int step = edgeRow or ring == 0 ? 1 : 2 * ring;
+			for(int column = centerColumn - ring; column <= centerColumn + ring; column += step)
+			{
+				if(column < 0 or column >= _columns)
+				{
+					continue;
+				}
+				for(int node = _cells[row * _columns + column]; node != NO_NODE;
+				    node = _nodes[node].next)
+				{
+					Neighbour neighbour = {squaredDistance(_nodes[node].point, point),
+					                       _nodes[node].point};
+					if((int)heap.size() < k)
+					{
+						heap.push_back(neighbour);
+						push_heap(heap.begin(), heap.end());
+					}
+					else if(neighbour < heap.front())
+					{
+						pop_heap(heap.begin(), heap.end());
+						heap.back() = neighbour;
+						push_heap(heap.begin(), heap.end());
+					}
+				}
+			}
+		}
+
+		unsigned __int128 bound = (unsigned long long)ring * _cellSize;
+		if((int)heap.size() == k and heap.front().distance < bound * bound)
+		{
+			break;
+		}
+	}
+	sort_heap(heap.begin(), heap.end());
+}
+
+
+/**
+ * Appends the k points nearest to the given point to the given vector,
+ * nearest first, or all the points if there are fewer than k
+ */
+void SpatialIndex::nearestPoints(const Point& point, const int k, vector<Point>& result) const
+{
+	vector<Neighbour> heap;
+	_nearest(point, k, heap);
+	for(size_t i = 0; i < heap.size(); i++)
+	{
+		result.push_back(heap[i].point);
+	}
+}
+
+
+/**
+ * Appends the points at a distance of at most the given radius from the given
+ * point to the given vector. The points of the square around the circle are
+ * collected, and those outside the circle are then dropped in place.
+ */
+void SpatialIndex::pointsInRadius(const Point& point, const double radius, vector<Point>& result) const
+{
+	if(!(radius >= 0))
+	{
+		return;
+	}
+	long long reach = (long long)ceil(min(radius, MAX_REACH));
+	size_t first = result.size();
+	_collect((long long)point.getX() - reach, (long long)point.getY() - reach,
+	         (long long)point.getX() + reach, (long long)point.getY() + reach, result);
+
+	long double squaredRadius = (long double)radius * radius;
+	size_t kept = first;
+	for(size_t i = first; i < result.size(); i++)
+	{
+		if(inRadius(result[i], point, squaredRadius))
+		{
+			result[kept++] = result[i];
+		}
+	}
+	result.erase(result.begin() + kept, result.end());
+}
+
+
+/**
+ * Answers a rectangle query for each of the n given pairs of corners, in
+ * order, appending the offset of the points of every query before them and
+ * the end of the points after the last one
+ */
+void SpatialIndex::pointsInRectangles(const Point* lows, const Point* highs, const int n,
+                                      vector<Point>& result, vector<int>& offsets) const
+{
+	for(int i = 0; i < n; i++)
+	{
+		offsets.push_back(result.size());
+		pointsInRectangle(lows[i], highs[i], result);
+	}
+	offsets.push_back(result.size());
+}
+
+
+/**
+ * Answers a nearest points query for each of the n given points. The
+ * queries are sorted by their cells, row after row, and answered in that
+ * order with a single heap, each writing its points to its own place in the
+ * given vector.
+ */
+void SpatialIndex::nearestPoints(const Point* points, const int n, const int k,
+                                 vector<Point>& result) const
+{
+	int count = max(min(k, _size), 0);
+	size_t first = result.size();
+	result.resize(first + (size_t)n * count, Point(0, 0));
+
+	vector<pair<int, int> > order(n);
+	for(int i = 0; i < n; i++)
+	{
+		order[i] = make_pair(_row(points[i].getY()) * _columns + _column(points[i].getX()), i);
+	}
+	sort(order.begin(), order.end());
+
+	vector<Neighbour> heap;
+	for(int i = 0; i < n; i++)
+	{
+		int query = order[i].second;
+		_nearest(points[query], count, heap);
+		for(int j = 0; j < count; j++)
+		{
+			result[first + (size_t)query * count + j] = heap[j].point;
+		}
+	}
+}
+
+
+/**
+ * Answers a radius query for each of the n given points, in order, appending
+ * the offset of the points of every query before them and the end of the
+ * points after the last one
+ */
+void SpatialIndex::pointsInRadius(const Point* points, const int n, const double radius,
+                                  vector<Point>& result, vector<int>& offsets) const
+{
+	for(int i = 0; i < n; i++)
+	{
+		offsets.push_back(result.size());
+		pointsInRadius(points[i], radius, result);
+	}
+	offsets.push_back(result.size());
+}
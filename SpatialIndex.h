@@ -0,0 +1,164 @@
+// SpatialIndex.h
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <vector>
+#include "Point.h"
+#include "PointSet.h"
+#include "PointSetObserver.h"
+
+using namespace std;
+
+/**
+ * This class answers spatial queries over the points of a PointSet: the
+ * points in a rectangle, the k nearest points to a given point, and the
+ * points within a given distance of it. It observes the set, so every add,
+ * remove or trim of the set updates the index in O(1) expected time, and
+ * an assignment rebuilds it.
+ * The points are held in a uniform grid of square cells spanning their
+ * bounding box, with about POINTS_PER_CELL points per cell, so a query only
+ * visits the cells near its answer instead of scanning the whole set. Points
+ * added outside the box are kept in the cells on its border, and the grid is
+ * rebuilt in O(n) for the points it holds once it has taken as many updates
+ * as it had points, which keeps the cells balanced as the set changes at an
+ * O(1) amortized cost per update. The nearest points are found by their
+ * exact squared distances.
+ */
+class SpatialIndex: public PointSetObserver
+{
+public:
+
+	/**
+	 * Builds the index of the given set, and attaches it to the set. The index
+	 * must be destroyed before the set.
+	 */
+	SpatialIndex(PointSet& set);
+
+	/**
+	 * Destructor. Detaches the index from its set.
+	 */
+	~SpatialIndex();
+
+	/**
+	 * Returns the number of points in the index
+	 */
+	int size() const;
+
+	/**
+	 * Appends the points whose coordinates lie between those of the given
+	 * corners, inclusive, to the given vector, in no particular order
+	 */
+	void pointsInRectangle(const Point& low, const Point& high, vector<Point>& result) const;
+
+	/**
+	 * Appends the k points nearest to the given point to the given vector,
+	 * nearest first, or all the points if there are fewer than k. Points at
+	 * the same distance are ordered by the x coordinate, and secondly by the y
+	 * coordinate.
+	 */
+	void nearestPoints(const Point& point, const int k, vector<Point>& result) const;
+
+	/**
+	 * Appends the points at a distance of at most the given radius from the
+	 * given point to the given vector, in no particular order
+	 */
+	void pointsInRadius(const Point& point, const double radius, vector<Point>& result) const;
+
+	/**
+	 * Answers a rectangle query for each of the n given pairs of corners.
+	 * The points of query i are appended to the given vector from
+	 * offsets[i] to offsets[i + 1], and the n + 1 offsets are appended to
+	 * the given offsets.
+	 */
+	void pointsInRectangles(const Point* lows, const Point* highs, const int n,
+	                        vector<Point>& result, vector<int>& offsets) const;
+
+	/**
+	 * Answers a nearest points query for each of the n given points. The
+	 * min(k, size()) points of query i are appended to the given vector from
+	 * i * min(k, size()), nearest first. The queries are answered in the
+	 * order of their cells, so that neighbouring queries share the cells they
+	 * visit.
+	 */
+	void nearestPoints(const Point* points, const int n, const int k, vector<Point>& result) const;
+
+	/**
+	 * Answers a radius query for each of the n given points, with the same
+	 * radius. The points of query i are appended to the given vector from
+	 * offsets[i] to offsets[i + 1], and the n + 1 offsets are appended to the
+	 * given offsets.
+	 */
+	void pointsInRadius(const Point* points, const int n, const double radius,
+	                    vector<Point>& result, vector<int>& offsets) const;
+
+	/** Adds a point added to the set to its cell */
+	void pointAdded(const Point& point);
+
+	/** Removes a point removed from the set from its cell */
+	void pointRemoved(const Point& point);
+
+	/** Rebuilds the grid for all the points of the set */
+	void setReset(const PointSet& set);
+
+private:
+
+	/** A point of the grid, in the list of its cell */
+	struct Node
+	{
+		Point point;
+		int next; // The next node of the cell, or NO_NODE
+	};
+
+	/** A point found by a nearest points query, with its squared distance */
+	struct Neighbour
+	{
+		unsigned __int128 distance;
+		Point point;
+
+		/** Orders the neighbours by distance, and then by the coordinates */
+		bool operator<(const Neighbour& other) const;
+	};
+
+	PointSet& _set;
+	long long _minX; // The corner of the grid
+	long long _minY;
+	long long _cellSize; // The width and height of every cell
+	int _columns;
+	int _rows;
+	vector<int> _cells; // The first node of every cell, row after row
+	vector<Node> _nodes;
+	vector<int> _freeNodes;
+	int _size;
+	int _updates; // The points added and removed since the grid was built
+	int _builtSize; // The number of points the grid was built for
+
+	/** Sizes the grid for the given points, and fills it with them */
+	void _build(const Point* points, const int n);
+
+	/** Rebuilds the grid for the points it holds */
+	void _rebuild();
+
+	/** Counts an update, and rebuilds the grid once the updates since it was
+	 * built outnumber its points */
+	void _countUpdate();
+
+	/** Returns the column of the given x coordinate, clamped to the grid */
+	int _column(const long long x) const;
+
+	/** Returns the row of the given y coordinate, clamped to the grid */
+	int _row(const long long y) const;
+
+	/** Appends the points whose coordinates lie between the given bounds,
+	 * inclusive, to the given vector */
+	void _collect(const long long lowX, const long long lowY, const long long highX,
+	              const long long highY, vector<Point>& result) const;
+
+	/** Leaves the k nearest points to the given point in the given heap,
+	 * nearest first */
+	void _nearest(const Point& point, const int k, vector<Neighbour>& heap) const;
+
+	SpatialIndex(const SpatialIndex&);
+	SpatialIndex& operator=(const SpatialIndex&);
+};
+
+#endif
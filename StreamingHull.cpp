@@ -0,0 +1,213 @@
+// StreamingHull.cpp
+#include "StreamingHull.h"
+#include "HullAlgorithms.h"
+
+using namespace std;
+
+// --------------------------------------------------------------------------------------
+// This file contains the implementation of the class StreamingHull.
+// --------------------------------------------------------------------------------------
+
+
+static const int UPPER_SIDE = 1;
+static const int LOWER_SIDE = -1;
+
+/** Returns the vertex held by the given chain entry as a point */
+static inline Point vertexPoint(const map<int, int>::const_iterator& vertex)
+{
+	return Point(vertex -> first, vertex -> second);
+}
+
+
+/**
+ * Constructs an empty chain, for the upper hull if the given side is 1 or the
+ * lower hull if it is -1
+ */
+StreamingHull::HullChain::HullChain(const int side): _side(side){}
+
+
+/** Returns the turn formed by the three given points, mirrored for the lower
+ * chain, so that the vertices of both chains form right turns */
+int StreamingHull::HullChain::_turn(const Point& p1, const Point& p2, const Point& p3) const
+{
+	return _side * getTurnDirection(&p1, &p2, &p3);
+}
+
+
+/**
+ * Adds the given point to the chain, unless it isn't strictly outside the
+ * chain. A point sharing its x coordinate with a vertex replaces the vertex
+ * if it is further out. Otherwise the point is outside iff it is strictly
+ * above (below, for the lower chain) the edge between its neighbours. Once
+ * inserted, the neighbours that no longer form a right turn with their own
+ * neighbours are removed, on both sides.
+ */
+bool StreamingHull::HullChain::add(const Point& point)
+{
+	map<int, int>::iterator next = _vertices.lower_bound(point.getX());
+	if(next != _vertices.end() and next -> first == point.getX())
+	{
+		if(_side * ((long long)point.getY() - next -> second) <= 0)
+		{
+			return false;
+		}
+		next = _vertices.erase(next);
+	}
+	else if(next != _vertices.end() and next != _vertices.begin())
+	{
+		map<int, int>::iterator previous = next;
+		--previous;
+		if(_turn(vertexPoint(previous), vertexPoint(next), point) <= 0)
+		{
+			return false;
+		}
+	}
+
+	map<int, int>::iterator inserted = _vertices.insert(next, make_pair(point.getX(),
+	                                                                    point.getY()));
+
+	// Removing the hidden vertices to the right of the new point
+	next = inserted;
+	++next;
+	while(next != _vertices.end())
+	{
+		map<int, int>::iterator afterNext = next;
+		++afterNext;
+		if(afterNext == _vertices.end() or
+		   _turn(point, vertexPoint(next), vertexPoint(afterNext)) < 0)
+		{
+			break;
+		}
+		next = _vertices.erase(next);
+	}
+
+	// Removing the hidden vertices to the left of the new point
+	while(inserted != _vertices.begin())
+	{
+		map<int, int>::iterator previous = inserted;
+		--previous;
+		if(previous == _vertices.begin())
+		{
+			break;
+		}
+		map<int, int>::iterator beforePrevious = previous;
+		--beforePrevious;
+		if(_turn(vertexPoint(beforePrevious), vertexPoint(previous), point) < 0)
+		{
+			break;
+		}
+		_vertices.erase(previous);
+	}
+	return true;
+}
+
+
+/** Returns the number of vertices in the chain */
+int StreamingHull::HullChain::size() const
+{
+	return _vertices.size();
+}
+
+
+/** Returns true iff the first vertex of this chain is the same as the first
+ * vertex of the given chain */
+bool StreamingHull::HullChain::sharesFirst(const HullChain& other) const
+{
+	return !_vertices.empty() and !other._vertices.empty() and
+	       *_vertices.begin() == *other._vertices.begin();
+}
+
+
+/** Returns true iff the last vertex of this chain is the same as the last
+ * vertex of the given chain */
+bool StreamingHull::HullChain::sharesLast(const HullChain& other) const
+{
+	return !_vertices.empty() and !other._vertices.empty() and
+	       *_vertices.rbegin() == *other._vertices.rbegin();
+}
+
+
+/** Adds the vertices of the chain to the given set */
+void StreamingHull::HullChain::addTo(PointSet& set) const
+{
+	for(map<int, int>::const_iterator vertex = _vertices.begin(); vertex != _vertices.end();
+	    ++vertex)
+	{
+		set.add(vertexPoint(vertex));
+	}
+}
+
+
+/**
+ * Default Constructor, for an empty stream
+ */
+StreamingHull::StreamingHull(): _upper(UPPER_SIDE), _lower(LOWER_SIDE), _pointsSeen(0){}
+
+
+/**
+ * Adds the given point to the stream. Both chains are offered the point, and
+ * it is a vertex of the hull iff either of them took it.
+ */
+bool StreamingHull::add(const Point& point)
+{
+	_pointsSeen++;
+	bool inUpper = _upper.add(point);
+	bool inLower = _lower.add(point);
+	return inUpper or inLower;
+}
+
+
+/**
+ * Adds the given array of points to the stream.
+ */
+int StreamingHull::add(const Point* points, const int n)
+{
+	int added = 0;
+	for(int i = 0; i < n; i++)
+	{
+		added += add(points[i]);
+	}
+	return added;
+}
+
+
+/**
+ * Returns the number of vertices of the current hull. The chains share their
+ * first vertex if only one point has the minimal x coordinate, and likewise
+ * the last one, which is the same vertex if all points are one.
+ */
+int StreamingHull::size() const
+{
+	int size = _upper.size() + _lower.size();
+	if(_upper.sharesFirst(_lower))
+	{
+		size--;
+	}
+	if(_upper.sharesLast(_lower) and _upper.size() > 1)
+	{
+		size--;
+	}
+	return size;
+}
+
+
+/**
+ * Returns the number of points added to the stream so far
+ */
+long long StreamingHull::pointsSeen() const
+{
+	return _pointsSeen;
+}
+
+
+/**
+ * Loads the given set with the vertices of the current hull, sorted by the x
+ * coordinate, and secondly by the y coordinate.
+ */
+void StreamingHull::getHull(PointSet& set) const
+{
+	set = PointSet();
+	_upper.addTo(set);
+	_lower.addTo(set);
+	set.sortSet(XCoordinateOrder());
+}
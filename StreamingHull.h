@@ -0,0 +1,108 @@
+// StreamingHull.h
+#ifndef STREAMING_HULL_H
+#define STREAMING_HULL_H
+
+#include <map>
+#include "Point.h"
+#include "PointSet.h"
+
+using namespace std;
+
+/**
+ * This class maintains the convex hull of a stream of points, fed to it one
+ * at a time or in batches. Only the current vertices of the hull are kept, in
+ * two chains ordered by the x coordinate - the upper hull and the lower hull -
+ * so the memory used is O(h), h being the size of the hull. A new point is
+ * located between its neighbours on each chain in O(log h): if it is not
+ * strictly outside both chains it is discarded at once, and otherwise it is
+ * inserted, removing the vertices it hides. The hull can be read at any
+ * moment, so the stream doesn't have to end.
+ */
+class StreamingHull
+{
+public:
+
+	/**
+	 * Default Constructor, for an empty stream
+	 */
+	StreamingHull();
+
+	/**
+	 * Adds the given point to the stream.
+	 * @return True iff the point is a vertex of the hull after being added
+	 */
+	bool add(const Point& point);
+
+	/**
+	 * Adds the given array of points to the stream.
+	 * @return The number of points that were vertices of the hull when added
+	 */
+	int add(const Point* points, const int n);
+
+	/**
+	 * Returns the number of vertices of the current hull
+	 */
+	int size() const;
+
+	/**
+	 * Returns the number of points added to the stream so far
+	 */
+	long long pointsSeen() const;
+
+	/**
+	 * Loads the given set with the vertices of the current hull, replacing its
+	 * points. The points are sorted by the x coordinate, and secondly by the y
+	 * coordinate.
+	 */
+	void getHull(PointSet& set) const;
+
+private:
+
+	/**
+	 * A single chain of the hull, holding the y coordinate of every vertex
+	 * keyed by its x coordinate. The upper chain keeps the vertices that are
+	 * highest for their x, with right turns between them from left to right,
+	 * and the lower chain is its mirror image.
+	 */
+	class HullChain
+	{
+	public:
+		/**
+		 * Constructs an empty chain, for the upper hull if the given side is 1
+		 * or the lower hull if it is -1
+		 */
+		HullChain(const int side);
+
+		/**
+		 * Adds the given point to the chain, unless it isn't strictly outside
+		 * the chain.
+		 * @return True iff the point was added
+		 */
+		bool add(const Point& point);
+
+		/** Returns the number of vertices in the chain */
+		int size() const;
+
+		/** Returns true iff the first (last) vertex of this chain is the same
+		 * as the first (last) vertex of the given chain */
+		bool sharesFirst(const HullChain& other) const;
+		bool sharesLast(const HullChain& other) const;
+
+		/** Adds the vertices of the chain to the given set */
+		void addTo(PointSet& set) const;
+
+	private:
+		map<int, int> _vertices;
+		int _side;
+
+		/** Returns the turn formed by the three given points, mirrored for the
+		 * lower chain, so that the vertices of both chains form right turns */
+		int _turn(const Point& p1, const Point& p2, const Point& p3) const;
+	};
+
+	HullChain _upper;
+	HullChain _lower;
+	long long _pointsSeen;
+};
+
+#endif
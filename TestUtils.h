@@ -0,0 +1,54 @@
+// TestUtils.h
+#ifndef TEST_UTILS_H
+#define TEST_UTILS_H
+
+#include <iostream>
+#include <string>
+#include <climits>
+
+using namespace std;
+
+/**
+ * What the PointSet* test programs share: the check that prints every result
+ * and remembers a failure, a generator of numbers of their own, and the
+ * coordinates at the limits. Every test is a program of its own, built from a
+ * single source file, so the state is kept in static variables.
+ */
+
+/** False once a check has failed */
+static bool passed = true;
+
+/** Prints whether the given condition holds. Takes the description as a C
+ * string, so that checking allocates nothing. */
+static inline void check(const char* description, const bool condition)
+{
+	cout << description << (condition ? " OK" : " FAILED") << endl;
+	if(!condition)
+	{
+		passed = false;
+	}
+}
+
+/** Prints whether the given condition holds */
+static inline void check(const string& description, const bool condition)
+{
+	check(description.c_str(), condition);
+}
+
+/**
+ * Returns a number in [low, high] from a linear congruential generator, so
+ * that a test draws the same numbers with any standard library. The range
+ * may span the whole of the 32 bit coordinates.
+ */
+static unsigned long long state = 1;
+static inline long long nextNumber(const long long low, const long long high)
+{
+	state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+	return low + (long long)((state >> 11) % ((unsigned long long)(high - low) + 1));
+}
+
+/** The coordinates of the points at the limits */
+static const int LIMITS[] = {INT_MIN, INT_MIN + 1, -1, 0, 1, INT_MAX - 1, INT_MAX};
+static const int LIMITS_COUNT = sizeof(LIMITS) / sizeof(LIMITS[0]);
+
+#endif